@@ -0,0 +1,388 @@
+﻿#include "Benchmarks.h"
+#include "NetworkIO.h"
+#include "NetworkParser.h"
+#include "ValuesBitSet.h"
+#include "SubsumptionVerifier.h"
+#include "NetworkGenerator.h"
+#include "Scheduler.h"
+#include "Permutations.h"
+#include "Config.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <regex>
+
+namespace {
+
+    // The vector<bool> bitset used before ValuesBitSet was word-packed, kept as the baseline.
+    class LegacyBitSet {
+    public:
+        void set(int index) {
+            if (static_cast<size_t>(index) >= bits_.size()) {
+                bits_.resize(index + 1, false);
+            }
+            bits_[index] = true;
+        }
+
+        int nextSetBit(int fromIndex) const {
+            for (size_t i = fromIndex; i < bits_.size(); ++i) {
+                if (bits_[i]) return static_cast<int>(i);
+            }
+            return -1;
+        }
+
+        int cardinality() const {
+            return static_cast<int>(std::count(bits_.begin(), bits_.end(), true));
+        }
+
+        bool isSubsetOf(const LegacyBitSet& other) const {
+            LegacyBitSet temp;
+            temp.bits_.resize(std::max(bits_.size(), other.bits_.size()), false);
+            for (size_t i = 0; i < bits_.size(); ++i) {
+                temp.bits_[i] = bits_[i];
+            }
+            for (size_t i = 0; i < std::min(temp.bits_.size(), other.bits_.size()); ++i) {
+                if (other.bits_[i]) temp.bits_[i] = false;
+            }
+            return std::none_of(temp.bits_.begin(), temp.bits_.end(), [](bool b) { return b; });
+        }
+
+        bool operator==(const LegacyBitSet& other) const {
+            size_t maxSize = std::max(bits_.size(), other.bits_.size());
+            for (size_t i = 0; i < maxSize; ++i) {
+                bool b1 = i < bits_.size() ? bits_[i] : false;
+                bool b2 = i < other.bits_.size() ? other.bits_[i] : false;
+                if (b1 != b2) return false;
+            }
+            return true;
+        }
+
+    private:
+        std::vector<bool> bits_;
+    };
+
+    template<typename Func>
+    double nanosPerOp(int ops, Func func) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / std::max(ops, 1);
+    }
+
+    template<typename BitSet>
+    void measure(const std::vector<BitSet>& sets, int repeats, double* results, long long& sink) {
+        int n = static_cast<int>(sets.size());
+
+        results[0] = nanosPerOp(n * repeats, [&]() {
+            for (int r = 0; r < repeats; ++r)
+                for (const auto& bs : sets)
+                    for (int i = bs.nextSetBit(0); i >= 0; i = bs.nextSetBit(i + 1))
+                        sink += i;
+            });
+
+        results[1] = nanosPerOp(n * repeats, [&]() {
+            for (int r = 0; r < repeats; ++r)
+                for (const auto& bs : sets)
+                    sink += bs.cardinality();
+            });
+
+        results[2] = nanosPerOp(n * n * repeats, [&]() {
+            for (int r = 0; r < repeats; ++r)
+                for (const auto& a : sets)
+                    for (const auto& b : sets)
+                        sink += a.isSubsetOf(b);
+            });
+
+        results[3] = nanosPerOp(n * n * repeats, [&]() {
+            for (int r = 0; r < repeats; ++r)
+                for (const auto& a : sets)
+                    for (const auto& b : sets)
+                        sink += (a == b);
+            });
+    }
+}
+
+namespace {
+
+    struct SubsumptionQuery {
+        Network* net0;
+        Network* net1;
+        bool found;
+    };
+
+    // Builds the network from its "[(i,j);...]" form; networks are shared between queries.
+    Network* readNetwork(int nbWires, const std::string& str,
+        std::unordered_map<std::string, std::unique_ptr<Network>>& networks) {
+        auto& net = networks[str];
+        if (!net) {
+            net = std::make_unique<Network>(nbWires);
+            std::istringstream in(str);
+            char c;
+            int i, j;
+            while (in >> c && c != ']') {
+                if (c == '(' && in >> i >> c >> j) {
+                    net->addComparator(i, j);
+                }
+            }
+            net->outputSet();
+        }
+        return net.get();
+    }
+}
+
+namespace {
+
+    // The per-line std::regex parsing used before NetworkParser, kept as the baseline.
+    std::vector<std::unique_ptr<Network>> parseWithRegex(const std::string& text, int nbWires) {
+        std::vector<std::unique_ptr<Network>> list;
+        std::regex re("\\d+");
+        std::istringstream in(text);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::vector<int> tokens;
+            for (std::sregex_iterator it(line.begin(), line.end(), re), end; it != end; ++it) {
+                tokens.push_back(std::stoi(it->str()));
+            }
+
+            if (!line.empty() && line[0] == '[') {
+                int offset = line.find("(0,") == std::string::npos ? 1 : 0;
+                auto net = std::make_unique<Network>(nbWires);
+                for (size_t i = 0; i + 1 < tokens.size(); i += 2) {
+                    net->addComparator(tokens[i] - offset, tokens[i + 1] - offset);
+                }
+                list.push_back(std::move(net));
+            }
+            else if (!line.empty() && line[0] == '{' && !list.empty()) {
+                list.back()->setOutput(tokens);
+            }
+        }
+        return list;
+    }
+}
+
+namespace {
+
+    // Points the files written by NetworkGenerator (levels, statistics) at the
+    // benchmark directory for its lifetime, so that benchmarks never overwrite
+    // the results of real runs.
+    class GeneratorDirs {
+    public:
+        explicit GeneratorDirs(const std::string& dir)
+            : outDir_(NetworkGenerator::getOutDir()), statsDir_(NetworkGenerator::getStatsDir()) {
+            NetworkIO::ensureDirectoryExists(dir);
+            NetworkGenerator::setOutDir(dir);
+            NetworkGenerator::setStatsDir(dir);
+        }
+
+        ~GeneratorDirs() {
+            NetworkGenerator::setOutDir(outDir_);
+            NetworkGenerator::setStatsDir(statsDir_);
+        }
+
+        GeneratorDirs(const GeneratorDirs&) = delete;
+        GeneratorDirs& operator=(const GeneratorDirs&) = delete;
+
+    private:
+        std::string outDir_;
+        std::string statsDir_;
+    };
+}
+
+namespace Benchmarks {
+
+    void valuesBitSet(const std::string& dir, int fromWires, int toWires) {
+        const char* names[] = { "nextSetBit loop", "cardinality", "subset", "equals" };
+        long long sink = 0;
+
+        for (int nbWires = fromWires; nbWires <= toWires; ++nbWires) {
+            std::vector<LegacyBitSet> legacy;
+            std::vector<ValuesBitSet> packed;
+
+            for (int k = 1; k <= 64; ++k) {
+                for (const auto& net : NetworkIO::readStatistics(dir, nbWires, k, 1)) {
+                    ValuesBitSet* values = net->outputSet()->bitValues();
+                    LegacyBitSet old;
+                    ValuesBitSet bs(size_t(1) << nbWires);
+                    for (int v = values->nextSetBit(0); v >= 0; v = values->nextSetBit(v + 1)) {
+                        old.set(v);
+                        bs.set(v);
+                    }
+                    legacy.push_back(old);
+                    packed.push_back(bs);
+                }
+            }
+
+            if (packed.empty()) continue;
+
+            int repeats = std::max(1, 20000 / static_cast<int>(packed.size() * packed.size()));
+            double oldNs[4], newNs[4];
+            measure(legacy, repeats, oldNs, sink);
+            measure(packed, repeats, newNs, sink);
+
+            std::cout << "n=" << nbWires << ", " << packed.size() << " output sets from " << dir << "\n";
+            for (int i = 0; i < 4; ++i) {
+                std::cout << "\t" << std::left << std::setw(16) << names[i]
+                    << std::right << std::fixed << std::setprecision(1)
+                    << std::setw(12) << oldNs[i] << " ns"
+                    << std::setw(12) << newNs[i] << " ns"
+                    << std::setw(10) << std::setprecision(2) << oldNs[i] / newNs[i] << "x\n";
+            }
+        }
+
+        std::cout << "(checksum " << sink << ")" << std::endl;
+    }
+
+    void subsumption(const std::string& file) {
+        std::ifstream in(file);
+        if (!in.is_open()) {
+            std::cerr << "Cannot open " << file << "\n";
+            return;
+        }
+
+        std::unordered_map<std::string, std::unique_ptr<Network>> networks;
+        std::vector<SubsumptionQuery> queries;
+        int nbWires, found;
+        std::string str0, str1;
+        while (in >> nbWires >> found >> str0 >> str1) {
+            queries.push_back({ readNetwork(nbWires, str0, networks), readNetwork(nbWires, str1, networks), found != 0 });
+        }
+        if (queries.empty()) return;
+
+        int repeats = std::max(1, 200000 / static_cast<int>(queries.size()));
+        std::cout << queries.size() << " queries (" << networks.size() << " networks) from " << file << "\n";
+
+        for (const std::string& name : SubsumptionVerifier::names()) {
+            std::unique_ptr<Subsumption> impl(SubsumptionVerifier::create(name));
+            int detected = 0, agree = 0;
+            for (const auto& q : queries) {
+                bool result = !impl->check(q.net0, q.net1).empty();
+                detected += result;
+                agree += (result == q.found);
+            }
+
+            double ns = nanosPerOp(static_cast<int>(queries.size()) * repeats, [&]() {
+                for (int r = 0; r < repeats; ++r)
+                    for (const auto& q : queries)
+                        impl->check(q.net0, q.net1);
+                });
+
+            std::cout << "\t" << std::left << std::setw(30) << name
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(12) << ns << " ns/query"
+                << std::setw(10) << detected << " detected"
+                << std::setw(10) << agree << "/" << queries.size() << " agree\n";
+        }
+    }
+    void schedulers(const std::string& dir, int nbWires, int level, int repeats) {
+        Permutations::get(0);
+        GeneratorDirs dirs(dir);
+        std::string configured = Config::getSchedulerImpl();
+
+        if (!NetworkIO::open(dir, nbWires, level)) {
+            std::cout << "Generating level " << level << " for n=" << nbWires << "\n";
+            NetworkGenerator generator(nbWires, 1, level, nullptr, nullptr);
+            NetworkIO::write(dir, nbWires, level, generator.createAll());
+        }
+
+        std::cout << "Expanding " << dir << "/networks_" << nbWires << "-" << level
+            << ".bin, " << Config::getNbThreads() << " threads, " << repeats << " runs\n";
+
+        for (const std::string& name : Scheduler::names()) {
+            Config::set("scheduler", name);
+            Scheduler::Stats total;
+            double millis = 0;
+
+            for (int r = 0; r < repeats; ++r) {
+                // the generator reports every level; keep it out of the table
+                std::ostringstream sink;
+                std::streambuf* out = std::cout.rdbuf(sink.rdbuf());
+
+                NetworkGenerator generator(nbWires, level + 1, level + 1, nullptr, nullptr);
+                Scheduler* scheduler = generator.getScheduler();
+                scheduler->setTracing(true);
+                scheduler->resetStats();
+
+                auto start = std::chrono::steady_clock::now();
+                generator.createAll();
+                auto end = std::chrono::steady_clock::now();
+                std::cout.rdbuf(out);
+
+                Scheduler::Stats stats = scheduler->stats();
+                millis += std::chrono::duration<double, std::milli>(end - start).count();
+                total.tasks += stats.tasks;
+                total.steals += stats.steals;
+                total.idleMillis += stats.idleMillis;
+                total.latencies.insert(total.latencies.end(), stats.latencies.begin(), stats.latencies.end());
+            }
+
+            auto& latencies = total.latencies;
+            std::sort(latencies.begin(), latencies.end());
+            auto percentile = [&](double q) {
+                if (latencies.empty()) return 0.0;
+                size_t i = std::min(latencies.size() - 1, static_cast<size_t>(q * latencies.size()));
+                return latencies[i] / 1e3;
+            };
+
+            std::cout << "\t" << std::left << std::setw(18) << name
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(10) << total.tasks * 1000.0 / millis << " tasks/s"
+                << std::setw(8) << total.steals << " steals"
+                << std::setw(7) << 100.0 * total.idleMillis / (millis * Config::getNbThreads()) << "% idle"
+                << "   latency us p50 " << percentile(0.5)
+                << " p99 " << percentile(0.99)
+                << " max " << percentile(1.0) << "\n";
+        }
+
+        Config::set("scheduler", configured);
+    }
+
+    void parser(const std::string& dir, int nbWires, int level, int repeats) {
+        std::string file = dir + "/networks_" + std::to_string(nbWires) + "-" + std::to_string(level) + ".txt";
+        std::ifstream in(file, std::ios::binary);
+        if (!in.is_open()) {
+            std::cout << "Generating level " << level << " for n=" << nbWires << "\n";
+            GeneratorDirs dirs(dir);
+            NetworkGenerator generator(nbWires, 1, level, nullptr, nullptr);
+            NetworkIO::writeText(dir, nbWires, level, generator.createAll());
+            in.open(file, std::ios::binary);
+        }
+
+        std::ostringstream buffer;
+        buffer << in.rdbuf();
+        std::string text = buffer.str();
+        long long lines = std::count(text.begin(), text.end(), '\n');
+        if (lines == 0) {
+            std::cerr << "No networks in " << file << "\n";
+            return;
+        }
+
+        int nbThreads = Config::getNbThreads();
+        std::unique_ptr<Scheduler> scheduler(Scheduler::create(Config::getSchedulerImpl(), nbThreads));
+        std::cout << lines << " lines from " << file << ", " << repeats << " runs\n";
+
+        auto report = [&](const std::string& name, auto parse) {
+            size_t count = 0;
+            double ns = nanosPerOp(static_cast<int>(lines * repeats), [&]() {
+                for (int r = 0; r < repeats; ++r) {
+                    count = parse().size();
+                }
+                });
+            std::cout << "\t" << std::left << std::setw(24) << name
+                << std::right << std::fixed << std::setprecision(0)
+                << std::setw(14) << 1e9 / ns << " lines/s"
+                << std::setw(10) << count << " networks\n";
+        };
+
+        report("regex (former)", [&]() { return parseWithRegex(text, nbWires); });
+        report("from_chars", [&]() { return NetworkParser::parse(text, nbWires, SIZE_MAX); });
+        report("from_chars, " + std::to_string(4 * nbThreads) + " chunks", [&]() {
+            return NetworkParser::parse(text, nbWires, SIZE_MAX, scheduler.get(), 4 * nbThreads);
+            });
+    }
+}
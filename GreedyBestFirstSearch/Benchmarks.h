@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+namespace Benchmarks {
+    // Word-packed ValuesBitSet vs. the former vector<bool> implementation,
+    // measured on the output sets of the networks listed in dir/statistics_<n>-<k>_run1.txt.
+    void valuesBitSet(const std::string& dir, int fromWires, int toWires);
+
+    // Replays the queries recorded through Config ("subsumptionLog") against every registered
+    // subsumption implementation, reporting ns/query and agreement with the recorded answers.
+    void subsumption(const std::string& file);
+
+    // Expands the level saved as dir/networks_<n>-<level>.bin (generated first if missing) with
+    // every registered scheduler, reporting throughput, steals, idle time and task latencies.
+    // The statistics of the generator runs are written to dir as well.
+    void schedulers(const std::string& dir, int nbWires, int level, int repeats);
+
+    // Parses the text file dir/networks_<n>-<level>.txt (generated first if missing) with the
+    // former regex parser and with NetworkParser, sequentially and in chunks, reporting lines/s.
+    // The statistics of the generator run are written to dir as well.
+    void parser(const std::string& dir, int nbWires, int level, int repeats);
+}
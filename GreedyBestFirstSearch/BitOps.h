@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace BitOps {
+
+    inline int popcount(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<int>(__popcnt64(x));
+#elif defined(__GNUC__)
+        return __builtin_popcountll(x);
+#else
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    // Index of the lowest set bit; x must not be 0.
+    inline int ctz(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return static_cast<int>(index);
+#elif defined(__GNUC__)
+        return __builtin_ctzll(x);
+#else
+        int index = 0;
+        while ((x & 1) == 0) {
+            x >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+
+    // Index of the highest set bit; x must not be 0.
+    inline int highestBit(uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanReverse64(&index, x);
+        return static_cast<int>(index);
+#elif defined(__GNUC__)
+        return 63 - __builtin_clzll(x);
+#else
+        int index = 0;
+        while (x >>= 1) {
+            index++;
+        }
+        return index;
+#endif
+    }
+}
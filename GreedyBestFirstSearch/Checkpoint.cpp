@@ -0,0 +1,164 @@
+#include "Checkpoint.h"
+#include "PackedComparator.h"
+#include "LevelStore.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+    template <typename T>
+    void put(std::vector<char>& out, const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    T get(std::istream& in) {
+        T value;
+        if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+            throw std::runtime_error("Truncated checkpoint");
+        }
+        return value;
+    }
+}
+
+std::string Checkpoint::progressFile(const std::string& dir, int nbWires) {
+    return dir + "/checkpoint_" + std::to_string(nbWires) + ".bin";
+}
+
+std::string Checkpoint::levelFile(const std::string& dir, int nbWires, int size) {
+    return dir + "/checkpoint_" + std::to_string(nbWires) + "-" + std::to_string(size) + ".level";
+}
+
+std::vector<char> Checkpoint::serialize() const {
+    std::vector<char> out;
+    out.insert(out.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    put(out, VERSION);
+    put(out, static_cast<uint16_t>(nbWires));
+    put(out, static_cast<int32_t>(size));
+    put(out, seed);
+    put(out, parents);
+    put(out, cursor);
+    put(out, checkedNetworks);
+
+    // the comparators as in the level file, see LevelStore
+    bool packed = PackedComparator::fits(nbWires);
+    put(out, static_cast<uint64_t>(networks.size()));
+    for (const auto& comparators : networks) {
+        if (comparators.size() / 2 > LevelStore::MAX_COMPARATORS) {
+            throw std::invalid_argument("Network too large to checkpoint: " + std::to_string(comparators.size() / 2) + " comparators");
+        }
+        out.push_back(static_cast<char>(comparators.size() / 2));
+        if (!packed) {
+            out.insert(out.end(), comparators.begin(), comparators.end());
+            continue;
+        }
+        for (size_t i = 0; i < comparators.size(); i += 2) {
+            out.push_back(static_cast<char>(PackedComparator(comparators[i], comparators[i + 1]).bits));
+        }
+    }
+
+    put(out, static_cast<uint64_t>(outputs.size()));
+    for (const OutputHash& hash : outputs) {
+        put(out, hash.lo);
+        put(out, hash.hi);
+    }
+    return out;
+}
+
+std::unique_ptr<Checkpoint> Checkpoint::read(const std::string& dir, int nbWires) {
+    std::string file = progressFile(dir, nbWires);
+    std::ifstream in(file, std::ios::binary);
+    if (!in.is_open()) {
+        return nullptr;
+    }
+
+    char magic[sizeof(MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a checkpoint: " + file);
+    }
+    if (get<uint16_t>(in) != VERSION) {
+        throw std::runtime_error("Unsupported checkpoint version: " + file);
+    }
+
+    auto checkpoint = std::make_unique<Checkpoint>();
+    checkpoint->nbWires = get<uint16_t>(in);
+    checkpoint->size = get<int32_t>(in);
+    checkpoint->seed = get<uint64_t>(in);
+    checkpoint->parents = get<uint64_t>(in);
+    checkpoint->cursor = get<uint64_t>(in);
+    checkpoint->checkedNetworks = get<int64_t>(in);
+    if (checkpoint->nbWires != nbWires || checkpoint->cursor > checkpoint->parents) {
+        throw std::runtime_error("Corrupted checkpoint: " + file);
+    }
+
+    bool packed = PackedComparator::fits(nbWires);
+    uint64_t count = get<uint64_t>(in);
+    checkpoint->networks.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        std::vector<uint8_t> comparators(2 * get<uint8_t>(in));
+        char* bytes = reinterpret_cast<char*>(comparators.data());
+        if (!in.read(bytes, packed ? comparators.size() / 2 : comparators.size())) {
+            throw std::runtime_error("Truncated checkpoint: " + file);
+        }
+        // unpacked in place, from the last comparator down
+        for (size_t c = packed ? comparators.size() / 2 : 0; c-- > 0;) {
+            PackedComparator comparator(comparators[c]);
+            comparators[2 * c] = static_cast<uint8_t>(comparator.wire0());
+            comparators[2 * c + 1] = static_cast<uint8_t>(comparator.wire1());
+        }
+        checkpoint->networks.push_back(std::move(comparators));
+    }
+
+    count = get<uint64_t>(in);
+    checkpoint->outputs.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        OutputHash hash;
+        hash.lo = get<uint64_t>(in);
+        hash.hi = get<uint64_t>(in);
+        checkpoint->outputs.push_back(hash);
+    }
+    return checkpoint;
+}
+
+CheckpointWriter::CheckpointWriter(std::string dir) : dir_(std::move(dir)) {
+    fs::create_directories(dir_);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    wait();
+}
+
+void CheckpointWriter::submit(std::function<void()> job) {
+    wait();
+    pending_ = std::async(std::launch::async, [job = std::move(job)]() {
+        try {
+            job();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Checkpoint failed: " << e.what() << std::endl;
+        }
+        });
+}
+
+void CheckpointWriter::wait() {
+    if (pending_.valid()) {
+        pending_.get();
+    }
+}
+
+void CheckpointWriter::writeFile(const std::string& file, const std::vector<char>& data) {
+    std::string temp = file + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size());
+        if (!out) {
+            throw std::runtime_error("Unable to write " + temp);
+        }
+    }
+    fs::rename(temp, file);
+}
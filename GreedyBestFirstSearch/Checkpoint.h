@@ -0,0 +1,66 @@
+#pragma once
+
+#include "OutputHash.h"
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Progress of a NetworkGenerator within a level, from which a run can be
+// resumed without expanding again the networks already expanded.
+//
+// A run keeps two files in the checkpoint directory:
+//   checkpoint_<n>-<size>.level   the networks of the previous level, the
+//                                 parents, as LevelStore records
+//   checkpoint_<n>.bin            the progress: the number of parents expanded,
+//                                 the networks of the working list and the
+//                                 output sets claimed so far
+//
+// The progress is only taken between two batches of expanders, so every
+// parent before the cursor is fully expanded and none after it has started.
+// Networks removed from the working list are not saved, but their output
+// sets are, so they are not generated again. The random choices of an
+// expander depend on the seed and on the index of its parent only.
+struct Checkpoint {
+    static constexpr char MAGIC[4] = { 'S', 'N', 'C', 'K' };
+    // 2: comparators packed in a byte up to 16 wires, here and in the level file
+    static constexpr uint16_t VERSION = 2;
+
+    int nbWires = 0;
+    int size = 0;                  // number of comparators of the level being built
+    uint64_t seed = 0;
+    uint64_t parents = 0;          // size of the previous level
+    uint64_t cursor = 0;           // parents already expanded
+    int64_t checkedNetworks = 0;
+    std::vector<std::vector<uint8_t>> networks;  // comparators as (wire0, wire1) pairs
+    std::vector<OutputHash> outputs;
+
+    static std::string progressFile(const std::string& dir, int nbWires);
+    static std::string levelFile(const std::string& dir, int nbWires, int size);
+
+    std::vector<char> serialize() const;
+    // nullptr if there is no checkpoint; throws std::runtime_error if it is not valid.
+    static std::unique_ptr<Checkpoint> read(const std::string& dir, int nbWires);
+};
+
+// Writes checkpoints on a background thread, one job at a time, each file
+// being written to a temporary file then renamed over the previous one.
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(std::string dir);
+    ~CheckpointWriter();
+
+    const std::string& dir() const { return dir_; }
+
+    // Runs job once the previous one is done; an exception is reported, not rethrown.
+    void submit(std::function<void()> job);
+    void wait();
+
+    static void writeFile(const std::string& file, const std::vector<char>& data);
+
+private:
+    std::string dir_;
+    std::future<void> pending_;
+};
@@ -0,0 +1,20 @@
+#include "ComparatorChain.h"
+#include <algorithm>
+
+ComparatorChain::Node::Node(std::shared_ptr<const Node> previous, const Comparator& comparator)
+    : previous(std::move(previous)), comparator(comparator) {
+    size = this->previous ? this->previous->size + 1 : 1;
+}
+
+ComparatorChain::ComparatorChain(const ComparatorChain& prefix, const Comparator& comparator)
+    : last_(std::make_shared<const Node>(prefix.last_, comparator)) {}
+
+std::vector<Comparator> ComparatorChain::toVector(int from) const {
+    std::vector<Comparator> comparators;
+    comparators.reserve(std::max(size() - from, 0));
+    for (const Node* node = last_.get(); node != nullptr && node->size > from; node = node->previous.get()) {
+        comparators.push_back(node->comparator);
+    }
+    std::reverse(comparators.begin(), comparators.end());
+    return comparators;
+}
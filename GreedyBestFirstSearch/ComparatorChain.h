@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Comparator.h"
+#include <memory>
+#include <vector>
+
+// Persistent list of comparators: extending a chain shares it rather than
+// copying it. The networks created from a parent all share the parent's
+// comparators, each one only owning the comparator it adds, and a chain
+// stays valid after the networks it came from are deleted.
+class ComparatorChain {
+public:
+    ComparatorChain() = default;
+    // The comparators of prefix, followed by comparator.
+    ComparatorChain(const ComparatorChain& prefix, const Comparator& comparator);
+
+    int size() const { return last_ ? last_->size : 0; }
+    bool empty() const { return !last_; }
+
+    // The comparators from index from to the last one, in order.
+    std::vector<Comparator> toVector(int from = 0) const;
+
+private:
+    struct Node {
+        Node(std::shared_ptr<const Node> previous, const Comparator& comparator);
+
+        std::shared_ptr<const Node> previous;
+        Comparator comparator;
+        int size;
+    };
+
+    std::shared_ptr<const Node> last_;
+};
@@ -1,29 +1,63 @@
 ﻿#include "Config.h"
 #include <thread>
+#include <random>
 
 std::unordered_map<std::string, std::string> Config::props;
 bool Config::initialized = false;
 
+// Fills in the keys that are not set yet; values given with set() are kept.
 void Config::init() {
     if (!initialized) {
-        props["subsumption"] = "SubsumptionMatchImpl";
-        props["tracing"] = "true";
-        props["maxWires"] = "18";
-        props["threads"] = "4";
-        props["monitorTime"] = "1000";
+        props.emplace("subsumption", "SubsumptionMatchImpl");
+        props.emplace("subsumptionLog", "");
+        props.emplace("scheduler", "FastThreadPool");
+        props.emplace("seed", "");
+        props.emplace("tracing", "true");
+        props.emplace("textExport", "false");
+        props.emplace("maxWires", "18");
+        props.emplace("threads", "4");
+        props.emplace("monitorTime", "1000");
+        props.emplace("levelBudget", "0");
+        props.emplace("checkpointDir", "");
+        props.emplace("checkpointInterval", "600");
+        props.emplace("resume", "false");
 
         initialized = true;
     }
 }
 
+void Config::set(const std::string& key, const std::string& value) {
+    props[key] = value;
+}
+
 std::string Config::getSubsumptionImpl() {
     return props.count("subsumption") ? props["subsumption"] : "SubsumptionMatchImpl";
 }
 
+std::string Config::getSubsumptionLog() {
+    return props.count("subsumptionLog") ? props["subsumptionLog"] : "";
+}
+
+std::string Config::getSchedulerImpl() {
+    return props.count("scheduler") ? props["scheduler"] : "FastThreadPool";
+}
+
+uint64_t Config::getSeed() {
+    if (!props.count("seed") || props["seed"].empty()) {
+        std::random_device rd;
+        props["seed"] = std::to_string((static_cast<uint64_t>(rd()) << 32) | rd());
+    }
+    return std::stoull(props["seed"]);
+}
+
 bool Config::isTracingEnabled() {
     return props.count("tracing") && props["tracing"] == "true";
 }
 
+bool Config::isTextExportEnabled() {
+    return props.count("textExport") && props["textExport"] == "true";
+}
+
 int Config::getMaxNbWires() {
     return props.count("maxWires") ? std::stoi(props["maxWires"]) : 18;
 }
@@ -39,3 +73,19 @@ int Config::getNbThreads() {
 int Config::getMonitorTime() {
     return props.count("monitorTime") ? std::stoi(props["monitorTime"]) : 0;
 }
+
+size_t Config::getLevelBudget() {
+    return props.count("levelBudget") ? std::stoull(props["levelBudget"]) : 0;
+}
+
+std::string Config::getCheckpointDir() {
+    return props.count("checkpointDir") ? props["checkpointDir"] : "";
+}
+
+int Config::getCheckpointInterval() {
+    return props.count("checkpointInterval") ? std::stoi(props["checkpointInterval"]) : 600;
+}
+
+bool Config::isResumeEnabled() {
+    return props.count("resume") && props["resume"] == "true";
+}
@@ -1,17 +1,33 @@
 ﻿#pragma once
 
 #include <string>
+#include <cstddef>
+#include <cstdint>
 #include <unordered_map>
 
 class Config {
 public:
     static void init();
+    static void set(const std::string& key, const std::string& value);
 
     static std::string getSubsumptionImpl();
+    static std::string getSubsumptionLog();
+    static std::string getSchedulerImpl();
+    // Seed for the randomized searches; drawn once per run if not configured.
+    static uint64_t getSeed();
     static bool isTracingEnabled();
+    // Whether levels are also written in the text format next to the binary one.
+    static bool isTextExportEnabled();
     static int getMaxNbWires();
     static int getNbThreads();
     static int getMonitorTime();
+    // Networks of a level kept in memory before it is spilled to disk; 0 for no limit.
+    static size_t getLevelBudget();
+    // Directory of the checkpoints of NetworkGenerator; empty to disable them.
+    static std::string getCheckpointDir();
+    static int getCheckpointInterval();
+    // Whether NetworkGenerator resumes from the checkpoint in getCheckpointDir().
+    static bool isResumeEnabled();
 
 private:
     static std::unordered_map<std::string, std::string> props;
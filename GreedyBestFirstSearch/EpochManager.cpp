@@ -0,0 +1,108 @@
+#include "EpochManager.h"
+
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+    // Slot indexes are handed out per thread and given back when the thread
+    // exits, so that pools started one after the other reuse the same slots.
+    std::mutex slotsMutex;
+    std::vector<int> freeSlots;
+    int nextSlot = 0;
+
+    struct SlotHolder {
+        int index;
+
+        SlotHolder() {
+            std::lock_guard<std::mutex> lock(slotsMutex);
+            if (freeSlots.empty()) {
+                index = nextSlot++;
+            }
+            else {
+                index = freeSlots.back();
+                freeSlots.pop_back();
+            }
+        }
+
+        ~SlotHolder() {
+            if (index < EpochManager::MAX_THREADS) {
+                std::lock_guard<std::mutex> lock(slotsMutex);
+                freeSlots.push_back(index);
+            }
+        }
+    };
+
+    // Retired objects accumulated by a thread before it tries to advance the epoch.
+    constexpr size_t RECLAIM_BATCH = 64;
+}
+
+int EpochManager::threadSlot() {
+    thread_local SlotHolder holder;
+    if (holder.index >= MAX_THREADS) {
+        throw std::runtime_error("Too many threads for the epoch manager.");
+    }
+    return holder.index;
+}
+
+EpochManager::Guard::Guard(EpochManager& manager) : manager_(manager) {
+    Slot& slot = manager_.slots_[threadSlot()];
+    if (slot.nesting++ == 0) {
+        slot.epoch.store(manager_.global_.load());
+    }
+}
+
+EpochManager::Guard::~Guard() {
+    Slot& slot = manager_.slots_[threadSlot()];
+    if (--slot.nesting == 0) {
+        slot.epoch.store(0, std::memory_order_release);
+    }
+}
+
+EpochManager::EpochManager() {}
+
+EpochManager::~EpochManager() {
+    reclaimAll();
+}
+
+void EpochManager::retire(void* ptr, void (*deleter)(void*)) {
+    Slot& slot = slots_[threadSlot()];
+    slot.retired.push_back({ ptr, deleter, global_.load() });
+
+    if (slot.retired.size() % RECLAIM_BATCH == 0) {
+        tryAdvance();
+        reclaim(slot, global_.load());
+    }
+}
+
+bool EpochManager::tryAdvance() {
+    uint64_t epoch = global_.load();
+    for (const Slot& slot : slots_) {
+        uint64_t local = slot.epoch.load();
+        if (local != 0 && local != epoch) {
+            return false;
+        }
+    }
+    return global_.compare_exchange_strong(epoch, epoch + 1);
+}
+
+void EpochManager::reclaim(Slot& slot, uint64_t epoch) {
+    size_t kept = 0;
+    for (const Retired& r : slot.retired) {
+        if (r.epoch + 2 <= epoch) {
+            r.deleter(r.ptr);
+        }
+        else {
+            slot.retired[kept++] = r;
+        }
+    }
+    slot.retired.resize(kept);
+}
+
+void EpochManager::reclaimAll() {
+    for (Slot& slot : slots_) {
+        for (const Retired& r : slot.retired) {
+            r.deleter(r.ptr);
+        }
+        slot.retired.clear();
+    }
+}
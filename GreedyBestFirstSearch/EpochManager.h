@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+// Epoch-based reclamation for objects unlinked from lock-free structures.
+//
+// Readers hold a Guard while they may dereference shared pointers. An object
+// retired while the global epoch is e is deleted once the epoch reaches e + 2:
+// by then every thread that could still see it has left its guard. The epoch
+// only advances when all active threads have observed the current one.
+class EpochManager {
+public:
+    static constexpr int MAX_THREADS = 256;
+
+    class Guard {
+    public:
+        explicit Guard(EpochManager& manager);
+        ~Guard();
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        EpochManager& manager_;
+    };
+
+    EpochManager();
+    ~EpochManager();
+
+    void retire(void* ptr, void (*deleter)(void*));
+
+    template <typename T>
+    void retire(T* ptr) {
+        retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    // Deletes everything retired so far; no guard may be held by any thread.
+    void reclaimAll();
+
+private:
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    // One cache line per live thread: the epoch it entered (0 when outside any
+    // guard) and the objects it retired, only touched by that thread. A slot
+    // outlives its thread and is taken over, with its retired objects, by the
+    // next thread that starts.
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{ 0 };
+        int nesting = 0;
+        std::vector<Retired> retired;
+    };
+
+    static int threadSlot();
+
+    bool tryAdvance();
+    void reclaim(Slot& slot, uint64_t epoch);
+
+    std::atomic<uint64_t> global_{ 1 };
+    Slot slots_[MAX_THREADS];
+};
@@ -1,12 +1,10 @@
 #include "ExecutorService.h"
 #include <random>
-#include <chrono>
 
 struct ExecutorService::Worker {
     ExecutorService& pool_;
-    std::deque<std::function<void()>> queue_;
+    std::deque<Job> queue_;
     std::mutex queueMutex_;
-    std::condition_variable cv_;
     std::thread thread_;
     int index_;
     std::mt19937 rng_;
@@ -17,57 +15,59 @@ struct ExecutorService::Worker {
     void start() {
         thread_ = std::thread([this]() {
             while (!pool_.stop_) {
-                std::function<void()> task;
+                Job job;
                 {
                     std::unique_lock<std::mutex> lock(queueMutex_);
                     if (!queue_.empty()) {
-                        task = std::move(queue_.back());
+                        job = queue_.back();
                         queue_.pop_back();
+                        --pool_.queued_;
                     }
                     else {
                         lock.unlock();
-                        if (!stealTask(task)) {
-                            std::unique_lock<std::mutex> waitLock(queueMutex_);
-                            cv_.wait_for(waitLock, std::chrono::milliseconds(1));
+                        if (!stealJob(job)) {
+                            std::unique_lock<std::mutex> waitLock(pool_.parkMutex_);
+                            pool_.parked(index_);
+                            pool_.parkCv_.wait(waitLock, [this]() { return pool_.stop_ || pool_.queued_ > 0; });
+                            pool_.unparked(index_);
                             continue;
                         }
+                        pool_.countSteal(index_);
                     }
                 }
 
-                if (task) {
-                    task();
-                    if (--pool_.tasksRemaining_ == 0) {
-                        std::unique_lock<std::mutex> lk(pool_.waitMutex_);
-                        pool_.waitCv_.notify_all();
-                    }
-                }
+                pool_.execute(index_, job);
             }
             });
     }
 
-    void enqueue(std::function<void()> task) {
+    void enqueue(const Job& job) {
         {
             std::lock_guard<std::mutex> lock(queueMutex_);
-            queue_.push_back(std::move(task));
+            queue_.push_back(job);
+            ++pool_.queued_;
         }
-        cv_.notify_one();
-    }
-
-    void notify() {
-        cv_.notify_one();
+        {
+            std::lock_guard<std::mutex> lock(pool_.parkMutex_);
+        }
+        pool_.parkCv_.notify_one();
     }
 
-    bool stealTask(std::function<void()>& task) {
-        std::uniform_int_distribution<int> dist(0, pool_.workers_.size() - 1);
-        for (int i = 0; i < 4; ++i) {
-            int victim = dist(rng_);
+    bool stealJob(Job& job) {
+        // start at a random victim, then try all of them before parking
+        int nbWorkers = static_cast<int>(pool_.workers_.size());
+        std::uniform_int_distribution<int> dist(0, nbWorkers - 1);
+        int start = dist(rng_);
+        for (int i = 0; i < nbWorkers; ++i) {
+            int victim = (start + i) % nbWorkers;
             if (victim == index_) continue;
 
             auto& v = pool_.workers_[victim];
             std::unique_lock<std::mutex> lock(v->queueMutex_);
             if (!v->queue_.empty()) {
-                task = std::move(v->queue_.front());
+                job = v->queue_.front();
                 v->queue_.pop_front();
+                --pool_.queued_;
                 return true;
             }
         }
@@ -76,7 +76,7 @@ struct ExecutorService::Worker {
 };
 
 ExecutorService::ExecutorService(int numThreads)
-    : stop_(false), tasksRemaining_(0) {
+    : Scheduler(numThreads), stop_(false) {
     for (int i = 0; i < numThreads; ++i) {
         workers_.emplace_back(std::make_unique<Worker>(*this, i));
     }
@@ -86,10 +86,11 @@ ExecutorService::ExecutorService(int numThreads)
 }
 
 ExecutorService::~ExecutorService() {
-    stop_ = true;
-    for (auto& w : workers_) {
-        w->notify();
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        stop_ = true;
     }
+    parkCv_.notify_all();
     for (auto& w : workers_) {
         if (w->thread_.joinable()) {
             w->thread_.join();
@@ -97,14 +98,8 @@ ExecutorService::~ExecutorService() {
     }
 }
 
-void ExecutorService::submit(std::function<void()> task) {
-    tasksRemaining_++;
-    getWorker()->enqueue(std::move(task));
-}
-
-void ExecutorService::wait() {
-    std::unique_lock<std::mutex> lock(waitMutex_);
-    waitCv_.wait(lock, [this] { return tasksRemaining_ == 0; });
+void ExecutorService::push(const Job& job) {
+    getWorker()->enqueue(job);
 }
 
 ExecutorService::Worker* ExecutorService::getWorker() {
@@ -112,5 +107,5 @@ ExecutorService::Worker* ExecutorService::getWorker() {
     if (localIndex == -1) {
         localIndex = nextIndex_++ % workers_.size();
     }
-    return workers_[localIndex].get();
+    return workers_[localIndex % workers_.size()].get();
 }
@@ -1,21 +1,24 @@
 #pragma once
 
+#include "Scheduler.h"
 #include <vector>
 #include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
-#include <functional>
 #include <memory>
 
-class ExecutorService {
+// Mutex-guarded queue per worker with a condition variable to park on. Each
+// submitting thread sticks to one worker; a worker runs its own queue from the
+// back (newest first) and steals from the front of randomly chosen victims.
+class ExecutorService : public Scheduler {
 public:
     explicit ExecutorService(int numThreads);
-    ~ExecutorService();
+    ~ExecutorService() override;
 
-    void submit(std::function<void()> task);
-    void wait();
+protected:
+    void push(const Job& job) override;
 
 private:
     struct Worker;
@@ -23,9 +26,10 @@ private:
 
     std::vector<std::unique_ptr<Worker>> workers_;
     std::atomic<bool> stop_;
-    std::atomic<int> tasksRemaining_;
     std::atomic<int> nextIndex_{ 0 };
 
-    std::mutex waitMutex_;
-    std::condition_variable waitCv_;
+    // Jobs sitting in the worker queues; idle workers park until it is non-zero.
+    std::atomic<int> queued_{ 0 };
+    std::mutex parkMutex_;
+    std::condition_variable parkCv_;
 };
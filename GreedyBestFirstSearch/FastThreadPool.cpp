@@ -1,22 +1,26 @@
 ﻿#include "FastThreadPool.h"
 
-FastThreadPool::FastThreadPool(size_t numThreads) : workers_(numThreads), taskCounters_(numThreads) {
-    for (auto& counter : taskCounters_) {
-        counter = 0;
-    }
+namespace {
+    // The pool and worker index of the current thread, if it is a worker.
+    thread_local FastThreadPool* currentPool = nullptr;
+    thread_local int currentWorker = 0;
+}
 
-    for (size_t i = 0; i < numThreads; ++i) {
+FastThreadPool::FastThreadPool(int numThreads) : Scheduler(numThreads) {
+    for (int i = 0; i < numThreads; ++i) {
+        deques_.push_back(std::make_unique<WorkStealingDeque>());
+    }
+    for (int i = 0; i < numThreads; ++i) {
         threads_.emplace_back([this, i]() { workerLoop(i); });
     }
 }
 
 FastThreadPool::~FastThreadPool() {
-    stop_ = true;
-
-    for (auto& worker : workers_) {
-        std::lock_guard<std::mutex> lock(worker.mutex);
-        worker.queue.emplace_back([] {});
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        stop_ = true;
     }
+    cvWork_.notify_all();
 
     for (auto& t : threads_) {
         if (t.joinable()) t.join();
@@ -24,49 +28,100 @@ FastThreadPool::~FastThreadPool() {
 
 }
 
-void FastThreadPool::wait() {
-    std::unique_lock<std::mutex> lock(waitMutex_);
-    cvDone_.wait(lock, [this]() { return tasksInFlight_ == 0; });
+void FastThreadPool::push(const Job& job) {
+    if (currentPool == this) {
+        deques_[currentWorker]->push(job);
+    }
+    else {
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        injected_.push_back(job);
+        ++injectedSize_;
+    }
+    signalWork();
 }
 
+void FastThreadPool::signalWork() {
+    signal_.fetch_add(1);
+    if (sleepers_.load() > 0) {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        cvWork_.notify_one();
+    }
+}
+
+bool FastThreadPool::takeInjected(int id, Job& job) {
+    if (injectedSize_.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(injectMutex_);
+    if (injected_.empty()) {
+        return false;
+    }
+
+    // take one job to run and a few more to our own deque, where other
+    // workers can steal them without going through the lock
+    job = injected_.front();
+    injected_.pop_front();
+    int moved = 1;
+    while (moved < INJECT_BATCH && !injected_.empty()) {
+        deques_[id]->push(injected_.front());
+        injected_.pop_front();
+        moved++;
+    }
+    injectedSize_ -= moved;
+    lock.unlock();
 
-void FastThreadPool::workerLoop(size_t id) {
-    auto& self = workers_[id];
-    while (!stop_) {
-        std::function<void()> task;
+    if (moved > 1) {
+        signalWork();
+    }
+    return true;
+}
 
-        {
-            std::lock_guard<std::mutex> lock(self.mutex);
-            if (!self.queue.empty()) {
-                task = std::move(self.queue.front());
-                self.queue.pop_front();
-            }
+bool FastThreadPool::findJob(int id, Job& job) {
+    if (deques_[id]->pop(job)) {
+        return true;
+    }
+    if (takeInjected(id, job)) {
+        return true;
+    }
+    int n = static_cast<int>(deques_.size());
+    for (int i = 1; i < n; ++i) {
+        int victim = (id + i) % n;
+        if (deques_[victim]->steal(job)) {
+            countSteal(id);
+            return true;
         }
+    }
+    return false;
+}
 
-        if (!task) {
-            for (size_t i = 0; i < workers_.size(); ++i) {
-                size_t victim = (id + i) % workers_.size();
-                if (victim == id) continue;
-
-                auto& other = workers_[victim];
-                std::lock_guard<std::mutex> lock(other.mutex);
-                if (!other.queue.empty()) {
-                    task = std::move(other.queue.back());
-                    other.queue.pop_back();
-                    break;
-                }
-            }
+void FastThreadPool::workerLoop(int id) {
+    currentPool = this;
+    currentWorker = id;
+
+    while (true) {
+        Job job;
+        if (findJob(id, job)) {
+            execute(id, job);
+            continue;
         }
 
-        if (task) {
-            task();
-            taskCounters_[id]++;
-            if (--tasksInFlight_ == 0) {
-                cvDone_.notify_all();
-            }
+        // look once more after taking the snapshot: anything submitted later
+        // changes the signal and keeps us from parking
+        uint64_t seen = signal_.load();
+        if (findJob(id, job)) {
+            execute(id, job);
+            continue;
         }
-        else {
-            std::this_thread::sleep_for(std::chrono::microseconds(50));
+
+        std::unique_lock<std::mutex> lock(parkMutex_);
+        if (stop_) {
+            break;
         }
+        ++sleepers_;
+        parked(id);
+        cvWork_.wait(lock, [this, seen]() { return stop_ || signal_.load() != seen; });
+        unparked(id);
+        --sleepers_;
     }
 }
@@ -1,57 +1,50 @@
 #pragma once
 
+#include "Scheduler.h"
+#include "WorkStealingDeque.h"
 #include <vector>
 #include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <future>
-#include <functional>
 #include <atomic>
-#include <iostream>
-
-class FastThreadPool {
+#include <memory>
+
+// Work-stealing thread pool.
+//
+// Each worker owns a Chase-Lev deque: jobs submitted from a worker go to its
+// own deque, jobs submitted from outside go to a shared injector queue that
+// workers drain in batches. An idle worker steals from the others and, when
+// nothing is left, parks on a condition variable until new work is signalled.
+class FastThreadPool : public Scheduler {
 public:
-    explicit FastThreadPool(size_t numThreads);
-    ~FastThreadPool();
-
-    template<typename Func>
-    auto submit(Func task) -> std::future<decltype(task())>;
+    explicit FastThreadPool(int numThreads);
+    ~FastThreadPool() override;
 
-    void wait();
+protected:
+    void push(const Job& job) override;
 
 private:
-    void workerLoop(size_t id);
+    static constexpr int INJECT_BATCH = 16;
 
-    struct Worker {
-        std::mutex mutex;
-        std::deque<std::function<void()>> queue;
-    };
+    void signalWork();
+    bool findJob(int id, Job& job);
+    bool takeInjected(int id, Job& job);
+    void workerLoop(int id);
 
-    std::vector<Worker> workers_;
+    std::vector<std::unique_ptr<WorkStealingDeque>> deques_;
     std::vector<std::thread> threads_;
-    std::vector<std::atomic<int>> taskCounters_;
 
-    std::atomic<bool> stop_ = false;
-    std::atomic<size_t> index_ = 0;
-    std::atomic<int> tasksInFlight_ = 0;
+    std::mutex injectMutex_;
+    std::deque<Job> injected_;
+    std::atomic<int> injectedSize_ = 0;
 
-    std::mutex waitMutex_;
-    std::condition_variable cvDone_;
-};
+    // Bumped on every submission; a worker parks only if it did not move
+    // since the worker last looked for work.
+    std::atomic<uint64_t> signal_ = 0;
+    std::atomic<int> sleepers_ = 0;
+    std::mutex parkMutex_;
+    std::condition_variable cvWork_;
 
-template<typename Func>
-auto FastThreadPool::submit(Func task) -> std::future<decltype(task())> {
-    using ReturnType = decltype(task());
-    auto packagedTask = std::make_shared<std::packaged_task<ReturnType()>>(std::move(task));
-    std::future<ReturnType> result = packagedTask->get_future();
-
-    size_t i = index_.fetch_add(1) % workers_.size();
-    {
-        std::lock_guard<std::mutex> lock(workers_[i].mutex);
-        workers_[i].queue.emplace_back([packagedTask]() { (*packagedTask)(); });
-    }
-
-    ++tasksInFlight_;
-    return result;
-}
+    std::atomic<bool> stop_ = false;
+};
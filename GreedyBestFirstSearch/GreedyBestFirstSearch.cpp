@@ -1,17 +1,156 @@
 ﻿#include "GreedyBestFirstSearch.h"
+#include "SubsumptionVerifier.h"
+#include "Config.h"
 #include <iostream>
-#include <random>
 #include <algorithm>
+#include <numeric>
+#include <queue>
+#include <unordered_set>
 
-GreedyBestFirstSearch::GreedyBestFirstSearch(FitnessEstimator* estimator, Subsumption* subsumption)
-    : fitnessEstimator_(estimator), subsumption_(subsumption) {}
+namespace {
+    int outSize(const Network* net) {
+        return net->outputSet()->size();
+    }
+}
+
+GreedyBestFirstSearch::GreedyBestFirstSearch(FitnessEstimator* estimator, Subsumption* subsumption, Scheduler* scheduler)
+    : fitnessEstimator_(estimator), subsumption_(subsumption),
+    subsumptionName_(SubsumptionVerifier::nameOf(subsumption)), scheduler_(scheduler), seed_(Config::getSeed()) {}
+
+uint64_t GreedyBestFirstSearch::seed() const {
+    return seed_;
+}
+
+template <typename Func>
+void GreedyBestFirstSearch::forEachTile(int nbTiles, Func& task) {
+    if (!scheduler_ || nbTiles <= 1 || subsumptionName_.empty()) {
+        for (int tile = 0; tile < nbTiles; ++tile) {
+            task(tile, subsumption_);
+        }
+        return;
+    }
+
+    struct TileTask {
+        Func* task;
+        const std::string* name;
+        int tile;
+
+        void operator()() {
+            (*task)(tile, SubsumptionVerifier::getInstance(*name));
+        }
+    };
+    for (int tile = 0; tile < nbTiles; ++tile) {
+        scheduler_->submit(TileTask{ &task, &subsumptionName_, tile });
+    }
+    scheduler_->wait();
+}
+
+void GreedyBestFirstSearch::markSubsumedBy(Network* candidate, const std::vector<Network*>& Rp,
+    std::vector<char>& subsumed) {
+    int count = static_cast<int>(Rp.size());
+    int size0 = outSize(candidate);
+    subsumed.assign(count, 0);
+
+    // a few tiles per worker: the candidate is compared once with each network
+    int length = count;
+    if (scheduler_) {
+        length = std::max(MIN_SWEEP, count / (4 * scheduler_->nbThreads()) + 1);
+    }
+
+    auto task = [&](int tile, Subsumption* verifier) {
+        int end = std::min(count, (tile + 1) * length);
+        for (int j = tile * length; j < end; ++j) {
+            // a network can only subsume networks with at least as many outputs
+            if (outSize(Rp[j]) >= size0) {
+                subsumed[j] = !verifier->check(candidate, Rp[j]).empty();
+            }
+        }
+        };
+    forEachTile(count > 0 ? (count + length - 1) / length : 0, task);
+}
+
+void GreedyBestFirstSearch::markSubsumed(const std::vector<Network*>& Rp, std::vector<char>& subsumed) {
+    int count = static_cast<int>(Rp.size());
+    subsumed.assign(count, 0);
+
+    // sorted by output size, Rp[order[j]] can only be subsumed by Rp[order[i]] for i < limit[j]
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return outSize(Rp[a]) < outSize(Rp[b]); });
+
+    std::vector<int> limit(count);
+    for (int j = count - 1; j >= 0; --j) {
+        bool last = j == count - 1 || outSize(Rp[order[j + 1]]) != outSize(Rp[order[j]]);
+        limit[j] = last ? j + 1 : limit[j + 1];
+    }
+
+    // tile (i-block, j-block) at a time, each task owning a column of j-blocks
+    auto task = [&](int tile, Subsumption* verifier) {
+        int jFrom = tile * TILE;
+        int jTo = std::min(count, jFrom + TILE);
+        for (int iFrom = 0; iFrom < limit[jTo - 1]; iFrom += TILE) {
+            for (int j = jFrom; j < jTo; ++j) {
+                Network* net1 = Rp[order[j]];
+                int iTo = std::min(limit[j], iFrom + TILE);
+                for (int i = iFrom; i < iTo && !subsumed[order[j]]; ++i) {
+                    if (i != j && !verifier->check(Rp[order[i]], net1).empty()) {
+                        subsumed[order[j]] = 1;
+                    }
+                }
+            }
+        }
+        };
+    forEachTile((count + TILE - 1) / TILE, task);
+}
+
+void GreedyBestFirstSearch::keepBest(std::vector<Network*>& Rp, std::vector<double>& fitness, int bound) {
+    int count = static_cast<int>(Rp.size());
+
+    // the bound best seen so far, worst on top: highest fitness, then lowest index
+    std::priority_queue<std::pair<double, int>> kept;
+    for (int m = 0; m < count; ++m) {
+        kept.emplace(fitness[m], -m);
+        if (kept.size() > static_cast<size_t>(bound)) {
+            kept.pop();
+        }
+    }
+
+    std::vector<char> keep(count, 0);
+    for (; !kept.empty(); kept.pop()) {
+        keep[-kept.top().second] = 1;
+    }
+
+    int size = 0;
+    for (int m = 0; m < count; ++m) {
+        if (keep[m]) {
+            Rp[size] = Rp[m];
+            fitness[size] = fitness[m];
+            size++;
+        }
+        else {
+            delete Rp[m];
+        }
+    }
+    Rp.resize(size);
+    fitness.resize(size);
+}
 
 std::vector<Network*> GreedyBestFirstSearch::generate(int n, int k, int bound, Network* prefix) {
     std::vector<Network*> Rp_prev, Rp;
+    // fitness[m] of Rp[m], computed once per network
+    std::vector<double> fitness, new_fitness;
+    std::vector<char> subsumed;
+    // output sets of the networks in Rp, to drop exact duplicates before any subsumption test
+    std::unordered_set<OutputHash, OutputHash::Hasher> outputs;
     Rp_prev.push_back(new Network(*prefix));
 
+    rng_.seed(seed_);
+    std::uniform_real_distribution<> dis(0, 1);
+
     for (int p = prefix->nbComparators() + 1; p <= k; ++p) {
         Rp.clear();
+        fitness.clear();
+        outputs.clear();
 
         for (Network* C : Rp_prev) {
             for (int i = 0; i < n - 1; ++i) {
@@ -19,65 +158,65 @@ std::vector<Network*> GreedyBestFirstSearch::generate(int n, int k, int bound, N
                     if (C->isRedundant(i, j)) continue;
 
                     Network* C_star = new Network(C, i, j);
+                    if (!outputs.insert(C_star->outputSet()->hash()).second) {
+                        delete C_star;
+                        continue;
+                    }
+
+                    double fitStar = fitnessEstimator_->compute(C_star);
+                    markSubsumedBy(C_star, Rp, subsumed);
 
                     std::vector<Network*> new_Rp;
-                    for (Network* Cprim : Rp) {
-                        if (!subsumption_->check(C_star, Cprim).empty()) {
+                    new_fitness.clear();
+                    for (size_t m = 0; m < Rp.size(); ++m) {
+                        Network* Cprim = Rp[m];
+                        if (subsumed[m]) {
+                            outputs.erase(Cprim->outputSet()->hash());
                             delete Cprim;
                             continue;
                         }
 
-                        if (Rp.size() >= bound &&
-                            fitnessEstimator_->compute(C_star) < fitnessEstimator_->compute(Cprim)) {
-                            std::random_device rd;
-                            std::mt19937 gen(rd());
-                            std::uniform_real_distribution<> dis(0, 1);
-                            double x = dis(gen);
+                        if (Rp.size() >= bound && fitStar < fitness[m]) {
+                            double x = dis(rng_);
 
-                            if (fitnessEstimator_->compute(C_star) < x &&
-                                fitnessEstimator_->compute(Cprim) > x) {
+                            if (fitStar < x && fitness[m] > x) {
+                                outputs.erase(Cprim->outputSet()->hash());
                                 delete Cprim;
                                 continue;
                             }
                         }
 
                         new_Rp.push_back(Cprim);
+                        new_fitness.push_back(fitness[m]);
                     }
 
                     new_Rp.push_back(C_star);
+                    new_fitness.push_back(fitStar);
                     Rp = std::move(new_Rp);
+                    fitness.swap(new_fitness);
                 }
             }
             delete C;
         }
 
         std::vector<Network*> filtered_Rp;
-        std::vector<bool> toDelete(Rp.size(), false);
-
-        for (size_t i = 0; i < Rp.size(); ++i) {
-            for (size_t j = 0; j < Rp.size(); ++j) {
-                if (i != j && !subsumption_->check(Rp[i], Rp[j]).empty()) {
-                    toDelete[j] = true;
-                }
-            }
-        }
+        new_fitness.clear();
+        markSubsumed(Rp, subsumed);
 
         for (size_t i = 0; i < Rp.size(); ++i) {
-            if (!toDelete[i]) {
+            if (!subsumed[i]) {
                 filtered_Rp.push_back(Rp[i]);
+                new_fitness.push_back(fitness[i]);
             }
             else {
                 delete Rp[i];
             }
         }
         Rp = std::move(filtered_Rp);
+        fitness.swap(new_fitness);
 
-        while (Rp.size() > static_cast<size_t>(bound)) {
-            auto worst = std::max_element(Rp.begin(), Rp.end(), [&](Network* a, Network* b) {
-                return fitnessEstimator_->compute(a) < fitnessEstimator_->compute(b);
-                });
-            delete* worst;
-            Rp.erase(worst);
+        if (bound >= 0 && Rp.size() > static_cast<size_t>(bound)) {
+            keepBest(Rp, fitness, bound);
         }
 
         Rp_prev = Rp;
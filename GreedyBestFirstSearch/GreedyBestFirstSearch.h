@@ -1,16 +1,52 @@
 #pragma once
 
 #include <vector>
+#include <random>
+#include <cstdint>
+#include <string>
 #include "Network.h"
 #include "FitnessEstimator.h"
 #include "Subsumption.h"
+#include "Scheduler.h"
 
 class GreedyBestFirstSearch {
 public:
-    GreedyBestFirstSearch(FitnessEstimator* estimator, Subsumption* subsumption);
+    // With a scheduler, the subsumption sweeps are split into tiles run by its
+    // workers, each with its own SubsumptionVerifier instance of the same
+    // implementation as subsumption; subsumption is then only used for sweeps
+    // too small to be worth splitting. Implementations missing from the
+    // registry are never split.
+    GreedyBestFirstSearch(FitnessEstimator* estimator, Subsumption* subsumption, Scheduler* scheduler = nullptr);
+    // Each call replays the same random choices: the generator is reseeded
+    // from Config ("seed") at the start of the search.
     std::vector<Network*> generate(int n, int k, int bound, Network* prefix);
+    uint64_t seed() const;
 
 private:
+    // Networks per tile side in the pairwise sweep.
+    static constexpr int TILE = 32;
+    // Fewest comparisons worth a task in the candidate sweep: most of them are
+    // rejected by the output signatures in a few nanoseconds.
+    static constexpr int MIN_SWEEP = 2048;
+
+    // subsumed[j] is set if candidate subsumes Rp[j].
+    void markSubsumedBy(Network* candidate, const std::vector<Network*>& Rp, std::vector<char>& subsumed);
+    // subsumed[j] is set if any other network of Rp subsumes Rp[j].
+    void markSubsumed(const std::vector<Network*>& Rp, std::vector<char>& subsumed);
+
+    // Keeps the bound networks of lowest fitness, in their order; of equal
+    // fitness the later ones, as removing the first worst one at a time did.
+    void keepBest(std::vector<Network*>& Rp, std::vector<double>& fitness, int bound);
+
+    // Runs task(tile, verifier) for every tile, on the scheduler if there is one.
+    template <typename Func>
+    void forEachTile(int nbTiles, Func& task);
+
     FitnessEstimator* fitnessEstimator_;
     Subsumption* subsumption_;
+    // Registry name of subsumption_'s implementation, empty if it has none.
+    const std::string subsumptionName_;
+    Scheduler* scheduler_;
+    const uint64_t seed_;
+    std::mt19937_64 rng_;
 };
@@ -0,0 +1,145 @@
+#include "LevelStore.h"
+#include "Statistics.h"
+#include "PackedComparator.h"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+    void createParentDirectory(const std::string& file) {
+        fs::path dir = fs::path(file).parent_path();
+        if (!dir.empty()) {
+            fs::create_directories(dir);
+        }
+    }
+}
+
+LevelStore::LevelStore(int nbWires, size_t budget, std::string spillFile)
+    : nbWires_(nbWires), budget_(budget), spillFile_(std::move(spillFile)) {}
+
+LevelStore::~LevelStore() {
+    if (spilled_) {
+        std::remove(spillFile_.c_str());
+    }
+}
+
+void LevelStore::assign(Chunk networks) {
+    size_ = networks.size();
+    spilled_ = budget_ > 0 && size_ > budget_;
+
+    if (spilled_) {
+        spill(networks);
+        memory_.clear();
+    }
+    else {
+        memory_ = std::move(networks);
+    }
+}
+
+void LevelStore::truncate(size_t count) {
+    if (count >= size_) return;
+    size_ = count;
+    if (!spilled_) {
+        memory_.resize(count);
+    }
+}
+
+void LevelStore::spill(const Chunk& networks) {
+    long long start = Statistics::currentTimeMillis();
+
+    createParentDirectory(spillFile_);
+    std::ofstream out(spillFile_, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Unable to open spill file: " + spillFile_);
+    }
+
+    writeRecords(out, networks);
+    if (!out) {
+        throw std::runtime_error("Unable to write spill file: " + spillFile_);
+    }
+    std::cout << "Spilled " << networks.size() << " networks to " << spillFile_ << " in "
+        << Statistics::currentTimeMillis() - start << " ms" << std::endl;
+}
+
+void LevelStore::writeRecords(std::ostream& out, const Chunk& networks) const {
+    // one byte for the number of comparators, then a byte per comparator, or per wire
+    bool packed = PackedComparator::fits(nbWires_);
+    std::vector<char> record;
+    for (const auto& net : networks) {
+        std::vector<Comparator> comparators = net->chain().toVector();
+        if (comparators.size() > MAX_COMPARATORS) {
+            throw std::invalid_argument("Network too large to store: " + std::to_string(comparators.size()) + " comparators");
+        }
+        record.clear();
+        record.push_back(static_cast<char>(comparators.size()));
+        for (const auto& c : comparators) {
+            if (packed) {
+                record.push_back(static_cast<char>(PackedComparator(c.getWire0(), c.getWire1()).bits));
+            }
+            else {
+                record.push_back(static_cast<char>(c.getWire0()));
+                record.push_back(static_cast<char>(c.getWire1()));
+            }
+        }
+        out.write(record.data(), record.size());
+    }
+}
+
+void LevelStore::save(const std::string& file) const {
+    if (spilled_) {
+        fs::copy_file(spillFile_, file, fs::copy_options::overwrite_existing);
+        return;
+    }
+
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    writeRecords(out, memory_);
+    if (!out) {
+        throw std::runtime_error("Unable to write file: " + file);
+    }
+}
+
+void LevelStore::load(const std::string& file, size_t count) {
+    size_ = count;
+    spilled_ = budget_ > 0 && count > budget_;
+    memory_.clear();
+
+    if (spilled_) {
+        createParentDirectory(spillFile_);
+        fs::copy_file(file, spillFile_, fs::copy_options::overwrite_existing);
+        return;
+    }
+
+    std::ifstream in(file, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Unable to open file: " + file);
+    }
+    readChunk(in, count, memory_);
+}
+
+void LevelStore::readChunk(std::ifstream& in, size_t count, Chunk& chunk) const {
+    chunk.clear();
+    chunk.reserve(count);
+
+    bool packed = PackedComparator::fits(nbWires_);
+    int bytesPerComparator = packed ? 1 : 2;
+    unsigned char bytes[2 * MAX_COMPARATORS];
+    for (size_t i = 0; i < count; ++i) {
+        int nbComparators = in.get();
+        if (nbComparators == EOF || !in.read(reinterpret_cast<char*>(bytes), bytesPerComparator * nbComparators)) {
+            throw std::runtime_error("Truncated level file");
+        }
+
+        auto net = std::make_unique<RuntimeNetwork>(nbWires_);
+        for (int c = 0; c < nbComparators; ++c) {
+            if (packed) {
+                net->addComparator(PackedComparator(bytes[c]).toComparator());
+            }
+            else {
+                net->addComparator(bytes[2 * c], bytes[2 * c + 1]);
+            }
+        }
+        chunk.push_back(std::move(net));
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "RuntimeNetwork.h"
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Networks of the last completed level.
+//
+// A level is kept in memory up to a budget of networks. A larger level is
+// spilled to a file holding only the comparators of each network (a
+// PackedComparator byte each up to 16 wires, a byte per wire above) and
+// streamed back in chunks of at most budget networks, whose output sets are
+// recomputed on first use. A budget of 0 keeps every level in memory.
+class LevelStore {
+public:
+    using Chunk = std::vector<std::unique_ptr<RuntimeNetwork>>;
+
+    // The number of comparators of a record is a single byte.
+    static constexpr size_t MAX_COMPARATORS = 255;
+
+    LevelStore(int nbWires, size_t budget, std::string spillFile);
+    ~LevelStore();
+
+    LevelStore(const LevelStore&) = delete;
+    LevelStore& operator=(const LevelStore&) = delete;
+
+    size_t size() const { return size_; }
+    bool isSpilled() const { return spilled_; }
+
+    // Replaces the level, spilling it if it exceeds the budget.
+    void assign(Chunk networks);
+    // Keeps the first count networks.
+    void truncate(size_t count);
+
+    // Writes the level to file, in the spill format; the level must not
+    // change meanwhile.
+    void save(const std::string& file) const;
+    // Replaces the level by the count networks saved in file.
+    void load(const std::string& file, size_t count);
+
+    // Calls f on successive chunks of the level, in order. A spilled chunk is
+    // freed once f returns, so f must be done with its networks by then.
+    template <typename Func>
+    void forEachChunk(Func f);
+
+private:
+    const int nbWires_;
+    const size_t budget_;
+    const std::string spillFile_;
+
+    Chunk memory_;
+    size_t size_ = 0;
+    bool spilled_ = false;
+
+    void spill(const Chunk& networks);
+    void writeRecords(std::ostream& out, const Chunk& networks) const;
+    void readChunk(std::ifstream& in, size_t count, Chunk& chunk) const;
+};
+
+template <typename Func>
+void LevelStore::forEachChunk(Func f) {
+    if (!spilled_) {
+        f(memory_);
+        return;
+    }
+
+    std::ifstream in(spillFile_, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("Unable to open spill file: " + spillFile_);
+    }
+
+    Chunk chunk;
+    for (size_t read = 0; read < size_; read += chunk.size()) {
+        readChunk(in, std::min(budget_, size_ - read), chunk);
+        f(chunk);
+    }
+}
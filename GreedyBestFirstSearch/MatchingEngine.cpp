@@ -0,0 +1,142 @@
+#include "MatchingEngine.h"
+
+#include <stdexcept>
+
+namespace {
+    constexpr int UNREACHED = MatchingEngine::MAX_SIZE + 1;
+}
+
+MatchingEngine::MatchingEngine() : n_(0) {}
+
+void MatchingEngine::init(const int* rows, int n) {
+    if (n > MAX_SIZE) {
+        throw std::invalid_argument("Too many vertices for the matching engine.");
+    }
+    n_ = n;
+    for (int u = 0; u < n; ++u) {
+        rows_[u] = static_cast<uint32_t>(rows[u]);
+        matchL_[u] = -1;
+        matchR_[u] = -1;
+    }
+}
+
+bool MatchingEngine::findPerfectMatching() {
+    // greedy start, then Hopcroft-Karp phases
+    for (int u = 0; u < n_; ++u) {
+        uint32_t free = rows_[u];
+        while (free) {
+            int c = BitOps::ctz(free);
+            free &= free - 1;
+            if (matchR_[c] < 0) {
+                matchL_[u] = c;
+                matchR_[c] = u;
+                break;
+            }
+        }
+    }
+
+    for (;;) {
+        int head = 0, tail = 0;
+        for (int u = 0; u < n_; ++u) {
+            if (matchL_[u] < 0) {
+                dist_[u] = 0;
+                queue_[tail++] = u;
+            }
+            else {
+                dist_[u] = UNREACHED;
+            }
+        }
+        if (tail == 0) return true;
+
+        bool found = false;
+        while (head < tail) {
+            int u = queue_[head++];
+            uint32_t adjacent = rows_[u];
+            while (adjacent) {
+                int c = BitOps::ctz(adjacent);
+                adjacent &= adjacent - 1;
+                int w = matchR_[c];
+                if (w < 0) {
+                    found = true;
+                }
+                else if (dist_[w] == UNREACHED) {
+                    dist_[w] = dist_[u] + 1;
+                    queue_[tail++] = w;
+                }
+            }
+        }
+        if (!found) return false;
+
+        for (int u = 0; u < n_; ++u) {
+            if (matchL_[u] < 0) augment(u);
+        }
+    }
+}
+
+bool MatchingEngine::augment(int u) {
+    uint32_t adjacent = rows_[u];
+    while (adjacent) {
+        int c = BitOps::ctz(adjacent);
+        adjacent &= adjacent - 1;
+        int w = matchR_[c];
+        if (w < 0 || (dist_[w] == dist_[u] + 1 && augment(w))) {
+            matchL_[u] = c;
+            matchR_[c] = u;
+            return true;
+        }
+    }
+    dist_[u] = UNREACHED;
+    return false;
+}
+
+uint32_t MatchingEngine::successors(int u) const {
+    // u -> w when w can take the column currently matched to u
+    return columns_[matchL_[u]] & ~(1u << u);
+}
+
+int MatchingEngine::findCycle(int* cycle) {
+    for (int c = 0; c < n_; ++c) columns_[c] = 0;
+    for (int u = 0; u < n_; ++u) {
+        uint32_t adjacent = rows_[u];
+        while (adjacent) {
+            columns_[BitOps::ctz(adjacent)] |= 1u << u;
+            adjacent &= adjacent - 1;
+        }
+    }
+
+    // iterative DFS on the left vertices; a back edge closes an alternating cycle
+    uint32_t done = 0;
+    for (int s = 0; s < n_; ++s) {
+        if ((done >> s) & 1) continue;
+        int depth = 1;
+        stack_[0] = s;
+        pending_[0] = successors(s);
+        uint32_t onStack = 1u << s;
+
+        while (depth > 0) {
+            int u = stack_[depth - 1];
+            if (pending_[depth - 1] == 0) {
+                done |= 1u << u;
+                onStack &= ~(1u << u);
+                depth--;
+                continue;
+            }
+            int w = BitOps::ctz(pending_[depth - 1]);
+            pending_[depth - 1] &= pending_[depth - 1] - 1;
+
+            if ((onStack >> w) & 1) {
+                int first = 0;
+                while (stack_[first] != w) first++;
+                for (int i = first; i < depth; ++i) cycle[i - first] = stack_[i];
+                return depth - first;
+            }
+            if ((done >> w) & 1) continue;
+
+            stack_[depth] = w;
+            pending_[depth] = successors(w) & ~done;
+            onStack |= 1u << w;
+            depth++;
+        }
+    }
+    return 0;
+}
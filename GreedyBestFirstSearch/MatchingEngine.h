@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include "BitOps.h"
+
+// Perfect matchings of a bipartite graph with at most MAX_SIZE vertices per side,
+// given as one adjacency mask per left vertex (bit c of rows[u]: u may go to column c).
+//
+// findPerfectMatching() is Hopcroft-Karp over the masks; enumerate() then lists
+// every other perfect matching with Uno's scheme: an alternating cycle of the
+// current matching M yields a new matching M', and the remaining ones are split
+// into those avoiding an edge e of M (searched from M') and those containing it
+// (searched from M). The object owns all its scratch, so nothing is allocated
+// while searching; keep one instance per thread.
+class MatchingEngine {
+public:
+    static constexpr int MAX_SIZE = 32;
+
+    MatchingEngine();
+
+    void init(const int* rows, int n);
+
+    // Fills match() with a perfect matching; false if there is none.
+    bool findPerfectMatching();
+
+    // Column matched to each left vertex.
+    const int* match() const { return matchL_; }
+    int size() const { return n_; }
+
+    // Calls visit(match) for every perfect matching other than the current one,
+    // until visit returns true. Returns true if the enumeration was stopped.
+    template <typename Visitor>
+    bool enumerate(Visitor& visit);
+
+private:
+    bool augment(int u);
+    int findCycle(int* cycle);
+    uint32_t successors(int u) const;
+
+    int n_;
+    uint32_t rows_[MAX_SIZE];
+    uint32_t columns_[MAX_SIZE];
+    int matchL_[MAX_SIZE];
+    int matchR_[MAX_SIZE];
+    int dist_[MAX_SIZE];
+    int queue_[MAX_SIZE];
+    int stack_[MAX_SIZE];
+    uint32_t pending_[MAX_SIZE];
+};
+
+template <typename Visitor>
+bool MatchingEngine::enumerate(Visitor& visit) {
+    int cycle[MAX_SIZE];
+    int length = findCycle(cycle);
+    if (length == 0) return false;
+
+    int saved[MAX_SIZE];
+    for (int i = 0; i < n_; ++i) saved[i] = matchL_[i];
+
+    // e = (u, c) belongs to M but not to M'
+    int u = cycle[0];
+    int c = matchL_[u];
+    for (int i = 0; i < length; ++i) {
+        int next = cycle[(i + 1) % length];
+        matchL_[next] = saved[cycle[i]];
+        matchR_[matchL_[next]] = next;
+    }
+    if (visit(static_cast<const int*>(matchL_))) return true;
+
+    rows_[u] &= ~(1u << c);
+    bool stopped = enumerate(visit);
+    rows_[u] |= 1u << c;
+    if (stopped) return true;
+
+    for (int i = 0; i < n_; ++i) {
+        matchL_[i] = saved[i];
+        matchR_[saved[i]] = i;
+    }
+
+    uint32_t rows[MAX_SIZE];
+    for (int i = 0; i < n_; ++i) {
+        rows[i] = rows_[i];
+        rows_[i] &= ~(1u << c);
+    }
+    rows_[u] = 1u << c;
+    stopped = enumerate(visit);
+    for (int i = 0; i < n_; ++i) rows_[i] = rows[i];
+    return stopped;
+}
@@ -1,61 +1,55 @@
 ﻿#include "Network.h"
 #include "SortingNetworks.h"
 #include "SubsumptionVerifier.h"
+#include "NetworkParser.h"
 #include <cmath>
 #include <random>
 #include <stdexcept>
 #include <sstream>
 #include <algorithm>
-#include <regex>
 #include <numeric>
+#include <mutex>
 
 Network::Network(int nbWires) : nbWires_(nbWires), last_(nbWires, -1), adjacents_(nbWires - 1, false) {
-    generator = new OutputGenerator(this);
     //std::cout << "[DEBUG] Network(" << nbWires << ") constructor called at " << this << std::endl;
 }
 
-Network::Network(const Network& other) : Network(other.nbWires_) {
+Network::Network(const Network& other)
+    : nbWires_(other.nbWires_), chain_(other.chain_), materialized_(false), prefix(other.prefix) {
     //std::cout << "[DEBUG] Network copy constructor called at " << this << " from " << &other << std::endl;
-    prefix = other.prefix;
-    for (const auto& c : other.comparators_) {
-        addComparator(c);
-    }
 
     if (other.outputSet_ != nullptr) {
         outputSet_ = new OutputSet(this);
         auto values = other.outputSet_->bitValues();
         for (int v = values->nextSetBit(0); v >= 0; v = values->nextSetBit(v + 1)) {
-            outputSet_->add(*Sequence::getInstance(nbWires_, v));
+            outputSet_->add(Sequence(nbWires_, v));
         }
+        outputSet_->computeMinMaxValues();
     }
 }
 
-Network::Network(Network* net, int i, int j) : Network(*net) {
-    //std::cout << "[DEBUG] Network(net, i, j) constructor called at " << this << std::endl;
-    addComparator(i, j);
-}
+Network::Network(Network* net, int i, int j) : Network(net, Comparator(i, j)) {}
 
-Network::Network(Network* net, const Comparator& c) : Network(*net) {
-    OutputSet* originalOut = net->outputSet();
-    auto values = originalOut->bitValues();
+Network::Network(Network* net, const Comparator& c)
+    : nbWires_(net->nbWires_), chain_(net->chain_, c), materialized_(false), prefix(net->prefix) {
+    outputSet_ = OutputGenerator(this).createFrom(*net->outputSet(), nbComparators() - 1);
+}
 
-    addComparator(c);
+void Network::materialize() const {
+    if (materialized_.load(std::memory_order_acquire)) return;
 
-    outputSet_ = new OutputSet(this);
-    int wire0 = c.getWire0();
-    int wire1 = c.getWire1();
+    // done once per network, the first time its vectors are needed
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (materialized_.load(std::memory_order_relaxed)) return;
 
-    for (int value = values->nextSetBit(0); value >= 0; value = values->nextSetBit(value + 1)) {
-        Sequence* seq = Sequence::getInstance(nbWires_, value);
-        bool bit0 = seq->get(wire0);
-        bool bit1 = seq->get(wire1);
-        if (bit0 && !bit1) {
-            seq = Sequence::getSwappedInstance(seq, wire0, wire1);
-        }
-        outputSet_->add(*seq);
+    Network* self = const_cast<Network*>(this);
+    self->last_.assign(nbWires_, -1);
+    self->adjacents_.assign(nbWires_ - 1, false);
+    for (const Comparator& c : chain_.toVector()) {
+        self->append(c);
     }
-
-    prefix = net->prefix;
+    materialized_.store(true, std::memory_order_release);
 }
 
 
@@ -64,7 +58,7 @@ int Network::nbWires() const {
 }
 
 int Network::size() const {
-    return comparators_.size();
+    return chain_.size();
 }
 
 int Network::nbComparators() const {
@@ -72,15 +66,17 @@ int Network::nbComparators() const {
 }
 
 int Network::nbLayers() const {
+    materialize();
     return layers_.size();
 }
 
 int Network::depth() const {
+    materialize();
     return layers_.size();
 }
 
 bool Network::isEmpty() const {
-    return comparators_.empty();
+    return chain_.empty();
 }
 
 bool Network::isMaximal() const {
@@ -88,6 +84,7 @@ bool Network::isMaximal() const {
 }
 
 bool Network::isGeneralized() const {
+    materialize();
     return generalized;
 }
 
@@ -105,6 +102,7 @@ int Network::compareByFitness(const Network& other) {
 }
 
 bool Network::contains(int wire0, int wire1) {
+    materialize();
     for (const auto& c : comparators_) {
         if (c.getWire0() == wire0 && c.getWire1() == wire1)
             return true;
@@ -113,6 +111,7 @@ bool Network::contains(int wire0, int wire1) {
 }
 
 bool Network::isRedundant(int wire0, int wire1) {
+    materialize();
     int idx0 = last_[wire0];
     int idx1 = last_[wire1];
     if (idx0 >= 0 && idx0 == idx1) return true;
@@ -120,8 +119,8 @@ bool Network::isRedundant(int wire0, int wire1) {
     OutputSet* out = outputSet();
     ValuesBitSet* values = out->bitValues();
     for (int value = values->nextSetBit(0); value >= 0; value = values->nextSetBit(value + 1)) {
-        auto s = Sequence::getInstance(nbWires_, value);
-        if (s->get(wire0) && !s->get(wire1)) {
+        Sequence s(nbWires_, value);
+        if (s.get(wire0) && !s.get(wire1)) {
             return false;
         }
     }
@@ -134,6 +133,16 @@ void Network::addComparator(int i, int j) {
 }
 
 void Network::addComparator(const Comparator& c) {
+    materialize();
+    chain_ = ComparatorChain(chain_, c);
+    append(c);
+
+    delete outputSet_;
+    outputSet_ = nullptr;
+    fitness = -1;
+}
+
+void Network::append(const Comparator& c) {
     comparators_.push_back(c);
     int i = c.getWire0();
     int j = c.getWire1();
@@ -164,16 +173,22 @@ void Network::addComparator(const Comparator& c) {
             adjacents_[i] = true;
         }
     }
-
-    outputSet_ = nullptr;
-    fitness = -1;
 }
 
 
 void Network::addNetwork(const Network& net, const std::vector<int>& wires) {
-    for (const auto& c : net.comparators_) {
+    OutputSet* previous = outputSet_;
+    outputSet_ = nullptr;
+    int from = nbComparators();
+
+    for (const auto& c : net.chain_.toVector()) {
         addComparator(wires[c.getWire0()], wires[c.getWire1()]);
     }
+
+    if (previous != nullptr) {
+        outputSet_ = OutputGenerator(this).createFrom(*previous, from);
+        delete previous;
+    }
 }
 
 Comparator* Network::createRandomComparator() {
@@ -210,39 +225,42 @@ Comparator* Network::addRandomComparator() {
 
 OutputSet* Network::outputSet() const {
     if (!outputSet_) {
-        outputSet_ = generator->createAll();
-        outputSet_->computeMinMaxValues();
+        outputSet_ = OutputGenerator(const_cast<Network*>(this)).createAll();
     }
     return outputSet_;
 }
 
 std::vector<int> Network::apply(const std::vector<int>& input) {
-    return generator->apply(input);
+    return OutputGenerator(this).apply(input);
 }
 
 int Network::apply(int input) {
-    return generator->apply(input).getValue();
+    return OutputGenerator(this).apply(input).getValue();
 }
 
 std::vector<Comparator>& Network::getComparators() {
+    materialize();
     return comparators_;
 }
 
 std::vector<Layer>& Network::getLayers() {
+    materialize();
     return layers_;
 }
 
 Layer& Network::layer(int index) {
+    materialize();
     return layers_[index];
 }
 
 Layer& Network::lastLayer() {
+    materialize();
     return layers_.back();
 }
 
 Network* Network::untangle() {
     std::vector<Comparator> comps;
-    for (const Comparator& c : comparators_) {
+    for (const Comparator& c : chain_.toVector()) {
         comps.emplace_back(c.getWire0(), c.getWire1());
     }
 
@@ -283,13 +301,17 @@ std::vector<int> Network::checkEquivalence(Network* other) {
     int n = nbWires_;
     std::vector<int> perm(n);
     std::iota(perm.begin(), perm.end(), 0);
+    if (size() != other->size()) {
+        return {};
+    }
+    std::string str = other->toParseableString();
 
     do {
         Network* pnet = this->permuteWires(perm);
 
         Network* untangled = pnet->untangle();
 
-        if (untangled->toParseableString() == other->toParseableString()) {
+        if (untangled->toParseableString() == str) {
             delete pnet;
             delete untangled;
             return perm;
@@ -306,7 +328,9 @@ std::vector<int> Network::checkEquivalence(Network* other) {
 
 std::vector<int> Network::checkSubsumption(Network* other) {
     Subsumption* verifier = SubsumptionVerifier::getInstance();
-    return verifier->check(this, other);
+    std::vector<int> perm = verifier->check(this, other);
+    SubsumptionVerifier::record(this, other, perm);
+    return perm;
 }
 
 void Network::setPrefix(Network* p) {
@@ -332,6 +356,8 @@ std::string Network::toString() const {
 }
 
 int Network::commonPrefix(Network* other) {
+    materialize();
+    other->materialize();
     int count = -1;
     int minSize = std::min(this->comparators_.size(), other->comparators_.size());
     for (int i = 0; i < minSize; ++i) {
@@ -345,11 +371,12 @@ int Network::commonPrefix(Network* other) {
 
 
 std::string Network::toParseableString() const {
+    std::vector<Comparator> comparators = chain_.toVector();
     std::ostringstream oss;
     oss << "[";
-    for (size_t i = 0; i < comparators_.size(); ++i) {
-        oss << comparators_[i];
-        if (i < comparators_.size() - 1)
+    for (size_t i = 0; i < comparators.size(); ++i) {
+        oss << comparators[i];
+        if (i < comparators.size() - 1)
             oss << ";";
     }
     oss << "]";
@@ -368,27 +395,24 @@ FitnessBad0 fitnessImpl;
 FitnessEstimator* Network::fitnessEstimator = &fitnessImpl;
 
 
-void Network::parse(const std::string& str) {
+void Network::parse(std::string_view str) {
     int offset = 0;
-    if (str.find("(0,") == std::string::npos) {
+    if (str.find("(0,") == std::string_view::npos) {
         offset = 1;
     }
 
-    std::regex re("\\d+");
-    std::sregex_iterator it(str.begin(), str.end(), re);
-    std::sregex_iterator end;
-
-    std::vector<int> tokens;
-    while (it != end) {
-        tokens.push_back(std::stoi(it->str()));
-        ++it;
-    }
-
-    for (size_t i = 0; i + 1 < tokens.size(); i += 2) {
-        int wire0 = tokens[i] - offset;
-        int wire1 = tokens[i + 1] - offset;
-        addComparator(wire0, wire1);
-    }
+    // the numbers come in (wire0, wire1) pairs
+    int wire0 = 0;
+    bool first = true;
+    NetworkParser::forEachNumber(str, [&](int value) {
+        if (first) {
+            wire0 = value - offset;
+        }
+        else {
+            addComparator(wire0, value - offset);
+        }
+        first = !first;
+        });
 }
 
 bool Network::isSorting() const {
@@ -398,9 +422,11 @@ bool Network::isSorting() const {
 
 Network::~Network() {
     //std::cout << "[DEBUG] Network destructor called at " << this << std::endl;
+    delete outputSet_;
 }
 
 Comparator* Network::lastComparator(int wire0, int wire1) const {
+    materialize();
     if (wire0 >= last_.size() || wire1 >= last_.size()) return nullptr;
     int idx0 = last_[wire0];
     int idx1 = last_[wire1];
@@ -409,21 +435,26 @@ Comparator* Network::lastComparator(int wire0, int wire1) const {
 }
 
 
-void Network::parseOutput(const std::string& str) {
+void Network::parseOutput(std::string_view str) {
     if (!outputSet_) {
         outputSet_ = new OutputSet(this);
     }
 
-    std::regex re("\\d+");
-    std::sregex_iterator it(str.begin(), str.end(), re);
-    std::sregex_iterator end;
+    NetworkParser::forEachNumber(str, [&](int value) {
+        outputSet_->add(Sequence(nbWires_, value));
+        });
+    outputSet_->computeMinMaxValues();
+}
+
+void Network::setOutput(const std::vector<int>& values) {
+    if (!outputSet_) {
+        outputSet_ = new OutputSet(this);
+    }
 
-    while (it != end) {
-        int value = std::stoi(it->str());
-        Sequence* seq = Sequence::getInstance(nbWires_, value);
-        outputSet_->add(*seq);
-        ++it;
+    for (int value : values) {
+        outputSet_->add(Sequence(nbWires_, value));
     }
+    outputSet_->computeMinMaxValues();
 }
 
 Network* Network::createRandom(int nbWires, int size) {
@@ -440,10 +471,23 @@ Network* Network::permuteWires(const std::vector<int>& p) {
     }
 
     Network* net = new Network(nbWires_);
-    for (const Comparator& c : comparators_) {
+    bool orderPreserving = true;
+    for (const Comparator& c : chain_.toVector()) {
         int i = c.getWire0();
         int j = c.getWire1();
         net->addComparator(p[i], p[j]);
+        orderPreserving = orderPreserving && ((i < j) == (p[i] < p[j]));
+    }
+
+    // When every comparator keeps its orientation, the permuted network sorts the
+    // permuted inputs exactly like this one, so its outputs are the permuted outputs.
+    if (orderPreserving && outputSet_ != nullptr) {
+        net->outputSet_ = new OutputSet(net);
+        ValuesBitSet* values = outputSet_->bitValues();
+        for (int v = values->nextSetBit(0); v >= 0; v = values->nextSetBit(v + 1)) {
+            net->outputSet_->add(Sequence(nbWires_, v).permute(p));
+        }
+        net->outputSet_->computeMinMaxValues();
     }
 
     return net;
@@ -451,13 +495,12 @@ Network* Network::permuteWires(const std::vector<int>& p) {
 
 
 Network* Network::split(int fromIndex) {
-    if (fromIndex < 0 || fromIndex >= comparators_.size()) {
-        throw std::invalid_argument("Split index must be between 0 and " + std::to_string(comparators_.size() - 1));
+    if (fromIndex < 0 || fromIndex >= size()) {
+        throw std::invalid_argument("Split index must be between 0 and " + std::to_string(size() - 1));
     }
 
     Network* net = new Network(nbWires_);
-    for (size_t i = fromIndex; i < comparators_.size(); ++i) {
-        const Comparator& c = comparators_[i];
+    for (const Comparator& c : chain_.toVector(fromIndex)) {
         net->addComparator(c.getWire0(), c.getWire1());
     }
     return net;
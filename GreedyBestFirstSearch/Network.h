@@ -2,8 +2,11 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <memory>
+#include <atomic>
 #include "Comparator.h"
+#include "ComparatorChain.h"
 #include "Layer.h"
 #include "OutputGenerator.h"
 #include "OutputSet.h"
@@ -12,10 +15,16 @@
 
 class OutputGenerator;
 
+// A network created from a parent, or copied, shares the parent's
+// ComparatorChain and only computes its output set. Its comparator vector,
+// layers and last comparator per wire are built the first time they are
+// needed, which most of the networks of a level, discarded right after their
+// output set is known, never are.
 class Network {
 public:
     Network(int nbWires);
     Network(const Network& other);
+    Network& operator=(const Network&) = delete;
     Network(Network* net, int i, int j);
     Network(Network* net, const Comparator& c);
 
@@ -52,8 +61,10 @@ public:
     std::vector<int> checkEquivalence(Network* other);
     std::vector<int> checkSubsumption(Network* other);
 
-    void parse(const std::string& str);
-    void parseOutput(const std::string& str);
+    void parse(std::string_view str);
+    void parseOutput(std::string_view str);
+    // Sets the output set from its values, as stored in a binary network file.
+    void setOutput(const std::vector<int>& values);
     std::string toParseableString() const;
     std::string toString() const;
     int commonPrefix(Network* other);
@@ -69,6 +80,8 @@ public:
     int getPrefixSize() const;
 
     std::vector<Comparator>& getComparators();
+    // The comparators without building the vectors of the network.
+    const ComparatorChain& chain() const { return chain_; }
     bool isSorting() const;
     Comparator* lastComparator(int wire0, int wire1) const;
     Network* untangle();
@@ -83,9 +96,10 @@ protected:
     //std::vector<Comparator*> last_;
     std::vector<int> last_;
     std::vector<bool> adjacents_;
+    ComparatorChain chain_;
+    mutable std::atomic<bool> materialized_{ true };
 
     mutable OutputSet* outputSet_ = nullptr;
-    OutputGenerator* generator = nullptr;
     Network* prefix = nullptr;
 
 public:
@@ -93,4 +107,7 @@ public:
 
 private:
     int computeDepth(int i, int j);
+    // Builds comparators_, layers_, last_ and adjacents_ from the chain, once.
+    void materialize() const;
+    void append(const Comparator& c);
 };
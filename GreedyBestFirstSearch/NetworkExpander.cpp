@@ -2,19 +2,26 @@
 #include "Comparator.h"
 #include "Sequence.h"
 #include "ValuesBitSet.h"
+#include "OutputCertificate.h"
 #include "Statistics.h"
 
 #include <mutex>
 #include <random>
 #include <cmath>
-#include <shared_mutex>
 #include <iostream>
 #include <chrono>
 
 static std::mutex coutMutex;
 
-NetworkExpander::NetworkExpander(NetworkGenerator* generator, RuntimeNetwork* net)
-    : generator_(generator), net_(net), workList_(generator->getWorkList()) {}
+NetworkExpander::NetworkExpander(NetworkGenerator* generator, RuntimeNetwork* net, uint64_t seed)
+    : generator_(generator), net_(net),
+    rng_(static_cast<uint32_t>(seed % (std::minstd_rand::modulus - 1) + 1)) {}
+
+double NetworkExpander::random() {
+    // One step of minstd_rand; its states are 1 .. modulus - 1.
+    rng_ = static_cast<uint32_t>(uint64_t(rng_) * std::minstd_rand::multiplier % std::minstd_rand::modulus);
+    return double(rng_ - 1) / (std::minstd_rand::modulus - 1);
+}
 
 int NetworkExpander::operator()() {
     return expandAll();
@@ -38,8 +45,25 @@ int NetworkExpander::expandAll() {
                 continue;
             }
 
+            // same output set as a network added before: it would only
+            // subsume it and be subsumed by it
+            if (!workList()->claimOutput(net1->outputSet()->hash())) {
+                if (Statistics::ENABLED) Statistics::redDuplicateOutput++;
+                continue;
+            }
+
+            // same output set up to a permutation of the wires; without
+            // subsumption the certificate stays 0 and is not indexed
+            if (NetworkGenerator::isSubsumptionEnabled()) {
+                net1->certificate = OutputCertificate::of(*net1->outputSet());
+                if (workList()->findEquivalent(net1.get())) {
+                    if (Statistics::ENABLED) Statistics::redPermutedOutput++;
+                    continue;
+                }
+            }
+
             removeSubsumed(net1.get());
-            workList_->addNetwork(std::move(net1));
+            workList()->addNetwork(std::move(net1));
             added++;
         }
     }
@@ -57,78 +81,91 @@ int NetworkExpander::expandAll() {
 }
 
 bool NetworkExpander::isSubsumed(RuntimeNetwork* net) {
-    bool full = workList_->isFull();
+    bool full = workList()->isFull();
     if (!NetworkGenerator::isSubsumptionEnabled() && !full) return false;
 
-    net->checkedSubsumedById = workList_->getMaxId();
+    net->checkedSubsumedById = workList()->getMaxId();
     double fitness = net->computeFitness();
-
-    std::shared_lock lock(generator_->getWorkLock());
-
-    for (int i = workList_->first(); i <= net->outSize; ++i) {
-        NetworkList* list = workList_->networkList(i);
-        for (int j = 0; j < list->size(); ++j) {
-            RuntimeNetwork* other = list->getNetwork(j);
-            if (other->isDead()) continue;
-
-            if (NetworkGenerator::isSubsumptionEnabled() && other->subsumes(net)) {
-                return true;
+    bool subsumption = NetworkGenerator::isSubsumptionEnabled();
+    const uint64_t* sizes = net->outputSet()->signature().sizeWords();
+    int rejected = 0;
+    bool subsumed = false;
+
+    EpochManager::Guard guard(workList()->epochs());
+
+    for (int i = workList()->first(); i <= net->outSize && !subsumed; ++i) {
+        workList()->networkList(i)->forEach([&](const NetworkList::Entry& other) {
+            // the cluster sizes of other must not exceed those of net
+            bool candidate = subsumption && !OutputSignature::sizesExceed(other.sizes, sizes, other.nbSizeWords);
+            if (subsumption && !candidate) rejected++;
+            bool byFitness = full && fitness > other.fitness;
+            if ((!candidate && !byFitness) || other.network->isDead()) return true;
+
+            if (candidate && other.network->subsumes(net)) {
+                subsumed = true;
+                return false;
             }
 
-            if (full && fitness > other->computeFitness()) {
-                double r1 = static_cast<double>(rand()) / RAND_MAX;
-                double r2 = static_cast<double>(rand()) / RAND_MAX;
-                if (r1 < fitness && r2 > other->computeFitness()) {
-                    return true;
+            if (byFitness) {
+                double r1 = random();
+                double r2 = random();
+                if (r1 < fitness && r2 > other.fitness) {
+                    subsumed = true;
+                    return false;
                 }
             }
-        }
+            return true;
+            });
     }
 
-    return false;
+    if (Statistics::ENABLED) {
+        Statistics::subTotal += rejected;
+        Statistics::subClusterSizeFail += rejected;
+    }
+    return subsumed;
 }
 
 void NetworkExpander::removeSubsumed(RuntimeNetwork* net) {
     auto start = std::chrono::high_resolution_clock::now();
 
-    net->checkedSubsumesId = workList_->getMaxId();
+    net->checkedSubsumesId = workList()->getMaxId();
     int kills = 0;
-    int killLimit = workList_->aliveSize() - NetworkGenerator::getWorkingListLimit();
+    int killLimit = workList()->aliveSize() - NetworkGenerator::getWorkingListLimit();
     double fitness = net->computeFitness();
-
-    std::shared_lock lock(generator_->getWorkLock());
-
-    for (int i = net->outSize + 1; i <= workList_->last(); ++i) {
-        NetworkList* list = workList_->networkList(i);
-        int n = list->size();
-        for (int j = 0; j < n; ++j) {
-            RuntimeNetwork* other = list->getNetwork(j);
-            if (other->isDead()) continue;
-
-            if (NetworkGenerator::isSubsumptionEnabled() && net->subsumes(other)) {
-                workList_->addDead(other);
-                continue;
+    bool subsumption = NetworkGenerator::isSubsumptionEnabled();
+    const uint64_t* sizes = net->outputSet()->signature().sizeWords();
+    int rejected = 0;
+
+    EpochManager::Guard guard(workList()->epochs());
+
+    for (int i = net->outSize + 1; i <= workList()->last(); ++i) {
+        workList()->networkList(i)->forEach([&](const NetworkList::Entry& other) {
+            // the cluster sizes of net must not exceed those of other
+            bool candidate = subsumption && !OutputSignature::sizesExceed(sizes, other.sizes, other.nbSizeWords);
+            if (subsumption && !candidate) rejected++;
+            bool byFitness = kills < killLimit && fitness < other.fitness && workList()->isFull();
+            if ((!candidate && !byFitness) || other.network->isDead()) return true;
+
+            if (candidate && net->subsumes(other.network)) {
+                workList()->addDead(other.network);
+                return true;
             }
 
-            if (kills < killLimit && workList_->isFull()) {
-                if (fitness < other->computeFitness()) {
-                    double r1 = static_cast<double>(rand()) / RAND_MAX;
-                    double r2 = static_cast<double>(rand()) / RAND_MAX;
-                    if (r1 > fitness && r2 < other->computeFitness()) {
-                        workList_->addDead(other);
-                        kills++;
-                    }
+            if (byFitness) {
+                double r1 = random();
+                double r2 = random();
+                if (r1 > fitness && r2 < other.fitness) {
+                    workList()->addDead(other.network);
+                    kills++;
                 }
             }
-        }
+            return true;
+            });
     }
 
-    if (workList_->deadSize() > 1000) {
-        std::unique_lock wlock(generator_->getWorkLock());
-        if (generator_->tryCleanupLock()) {
-            workList_->removeAllDead();
-            generator_->unlockCleanup();
-        }
+    if (Statistics::ENABLED) {
+        Statistics::subTotal += rejected;
+        Statistics::subClusterSizeFail += rejected;
     }
 
     auto end = std::chrono::high_resolution_clock::now();
@@ -153,8 +190,8 @@ bool NetworkExpander::isRedundant(RuntimeNetwork* net, int wire0, int wire1) {
     ValuesBitSet* values = out->bitValues();
 
     for (int value = values->nextSetBit(0); value >= 0; value = values->nextSetBit(value + 1)) {
-        Sequence* seq = Sequence::getInstance(Statistics::nbWires, value);
-        if (seq->get(wire0) && !seq->get(wire1)) {
+        Sequence seq(Statistics::nbWires, value);
+        if (seq.get(wire0) && !seq.get(wire1)) {
             redundant = false;
             break;
         }
@@ -3,20 +3,30 @@
 #include "RuntimeNetwork.h"
 #include "WorkingList.h"
 #include "NetworkGenerator.h"
+#include "Task.h"
+#include <cstdint>
 
 
 class NetworkExpander {
 public:
-    NetworkExpander(NetworkGenerator* generator, RuntimeNetwork* net);
+    // seed drives the random pruning of the working list when it is full.
+    NetworkExpander(NetworkGenerator* generator, RuntimeNetwork* net, uint64_t seed);
     int operator()();
 
 private:
     RuntimeNetwork* net_;
     NetworkGenerator* generator_;
-    WorkingList* workList_;
+    // State of a minstd_rand generator, kept as 32 bits so that the expander
+    // fits inline in a Task.
+    uint32_t rng_;
 
     int expandAll();
     bool isSubsumed(RuntimeNetwork* net);
     void removeSubsumed(RuntimeNetwork* net);
     bool isRedundant(RuntimeNetwork* net, int wire0, int wire1);
+    double random();
+    WorkingList* workList() const { return generator_->getWorkList(); }
 };
+
+static_assert(sizeof(NetworkExpander) <= Task::PAYLOAD_WORDS * sizeof(Task::Word),
+    "NetworkExpander must fit inline in a Task.");
@@ -0,0 +1,263 @@
+#include "NetworkFile.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    size_t align8(size_t n) {
+        return (n + 7) & ~size_t(7);
+    }
+
+    size_t bitsetWords(int nbWires) {
+        return ((size_t(1) << nbWires) + 63) / 64;
+    }
+
+    size_t comparatorBytes(bool packed, const NetworkFile::Record& record) {
+        return (packed ? 1 : 2) * size_t(record.nbComparators);
+    }
+
+    size_t outputBytes(int nbWires, const NetworkFile::Record& record) {
+        return record.encoding == NetworkFile::BITSET
+            ? bitsetWords(nbWires) * sizeof(uint64_t)
+            : record.outSize * sizeof(uint32_t);
+    }
+}
+
+void NetworkFile::write(const std::string& path, int nbWires, const std::vector<std::unique_ptr<Network>>& list) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Unable to open file: " + path);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.nbWires = static_cast<uint8_t>(nbWires);
+    header.count = list.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<uint64_t> index;
+    index.reserve(list.size());
+    uint64_t offset = sizeof(header);
+
+    std::vector<char> buffer;
+    size_t words = bitsetWords(nbWires);
+    bool packed = packsComparators(VERSION, nbWires);
+    for (const auto& net : list) {
+        std::vector<Comparator> comparators = net->chain().toVector();
+        const OutputSet* outputSet = net->outputSet();
+        if (comparators.size() > UINT8_MAX) {
+            throw std::invalid_argument("Network too large to write: " + std::to_string(comparators.size()) + " comparators");
+        }
+
+        Record record{};
+        record.nbComparators = static_cast<uint8_t>(comparators.size());
+        record.outSize = static_cast<uint32_t>(outputSet->size());
+        record.encoding = record.outSize * sizeof(uint32_t) < words * sizeof(uint64_t) ? SORTED_VALUES : BITSET;
+
+        size_t outputsAt = align8(sizeof(record) + comparatorBytes(packed, record));
+        buffer.assign(outputsAt + align8(outputBytes(nbWires, record)), 0);
+        std::memcpy(buffer.data(), &record, sizeof(record));
+        for (size_t i = 0; i < comparators.size(); ++i) {
+            if (packed) {
+                PackedComparator c(comparators[i].getWire0(), comparators[i].getWire1());
+                buffer[sizeof(record) + i] = static_cast<char>(c.bits);
+            }
+            else {
+                buffer[sizeof(record) + 2 * i] = static_cast<char>(comparators[i].getWire0());
+                buffer[sizeof(record) + 2 * i + 1] = static_cast<char>(comparators[i].getWire1());
+            }
+        }
+
+        const ValuesBitSet* bits = outputSet->bitValues();
+        if (record.encoding == BITSET) {
+            std::memcpy(buffer.data() + outputsAt, bits->words(), std::min(bits->nbWords(), words) * sizeof(uint64_t));
+        }
+        else {
+            uint32_t* values = reinterpret_cast<uint32_t*>(buffer.data() + outputsAt);
+            for (size_t w = 0; w < bits->nbWords(); ++w) {
+                for (uint64_t b = bits->words()[w]; b != 0; b &= b - 1) {
+                    *values++ = static_cast<uint32_t>(w * 64 + BitOps::ctz(b));
+                }
+            }
+        }
+
+        out.write(buffer.data(), buffer.size());
+        index.push_back(offset);
+        offset += buffer.size();
+    }
+
+    out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(uint64_t));
+    header.indexOffset = offset;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!out) {
+        throw std::runtime_error("Unable to write file: " + path);
+    }
+}
+
+NetworkView::NetworkView(int nbWires, const NetworkFile::Record* record, bool packed)
+    : nbWires_(nbWires), packed_(packed), record_(record) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(record);
+    comparators_ = bytes + sizeof(NetworkFile::Record);
+    outputs_ = bytes + align8(sizeof(NetworkFile::Record) + comparatorBytes(packed, *record));
+}
+
+bool NetworkView::contains(int value) const {
+    if (record_->encoding == NetworkFile::BITSET) {
+        const uint64_t* words = static_cast<const uint64_t*>(outputs_);
+        return (words[value / 64] >> (value % 64)) & 1;
+    }
+    const uint32_t* values = static_cast<const uint32_t*>(outputs_);
+    return std::binary_search(values, values + record_->outSize, static_cast<uint32_t>(value));
+}
+
+std::unique_ptr<Network> NetworkView::toNetwork() const {
+    auto net = std::make_unique<Network>(nbWires_);
+    for (int i = 0; i < nbComparators(); ++i) {
+        net->addComparator(wire0(i), wire1(i));
+    }
+
+    std::vector<int> values;
+    values.reserve(outSize());
+    forEachValue([&](int value) { values.push_back(value); });
+    net->setOutput(values);
+    return net;
+}
+
+MappedNetworkFile::MappedNetworkFile(const std::string& path) : path_(path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Unable to open file: " + path);
+    }
+    file_ = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        throw std::runtime_error("Unable to map file: " + path);
+    }
+    length_ = static_cast<size_t>(size.QuadPart);
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Unable to map file: " + path);
+    }
+    mapping_ = mapping;
+    data_ = static_cast<const uint8_t*>(view);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open file: " + path);
+    }
+
+    struct stat st;
+    void* view = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        length_ = static_cast<size_t>(st.st_size);
+        view = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        throw std::runtime_error("Unable to map file: " + path);
+    }
+    data_ = static_cast<const uint8_t*>(view);
+#endif
+
+    try {
+        validate();
+    }
+    catch (...) {
+        unmap();
+        throw;
+    }
+}
+
+MappedNetworkFile::~MappedNetworkFile() {
+    unmap();
+}
+
+void MappedNetworkFile::unmap() {
+    if (data_ == nullptr) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+#else
+    ::munmap(const_cast<uint8_t*>(data_), length_);
+#endif
+    data_ = nullptr;
+}
+
+void MappedNetworkFile::validate() {
+    if (length_ < sizeof(NetworkFile::Header)) {
+        throw std::runtime_error("Not a network file: " + path_);
+    }
+    header_ = reinterpret_cast<const NetworkFile::Header*>(data_);
+    if (std::memcmp(header_->magic, NetworkFile::MAGIC, sizeof(NetworkFile::MAGIC)) != 0) {
+        throw std::runtime_error("Not a network file: " + path_);
+    }
+    if (header_->version < 1 || header_->version > NetworkFile::VERSION) {
+        throw std::runtime_error("Unsupported network file version " + std::to_string(header_->version) + ": " + path_);
+    }
+    if (header_->nbWires < 1 || header_->nbWires > OutputSet::MAX_WIRES) {
+        throw std::runtime_error("Corrupted network file: " + path_);
+    }
+    if (header_->indexOffset % 8 != 0 || header_->indexOffset > length_
+        || header_->count > (length_ - header_->indexOffset) / sizeof(uint64_t)) {
+        throw std::runtime_error("Corrupted network file: " + path_);
+    }
+    index_ = reinterpret_cast<const uint64_t*>(data_ + header_->indexOffset);
+
+    for (size_t i = 0; i < size(); ++i) {
+        uint64_t offset = index_[i];
+        if (offset % 8 != 0 || offset < sizeof(NetworkFile::Header) || offset + sizeof(NetworkFile::Record) > header_->indexOffset) {
+            throw std::runtime_error("Corrupted network file: " + path_);
+        }
+        const auto* record = reinterpret_cast<const NetworkFile::Record*>(data_ + offset);
+        size_t end = offset + align8(sizeof(NetworkFile::Record) + comparatorBytes(packsComparators(), *record)) + outputBytes(nbWires(), *record);
+        if (record->encoding > NetworkFile::BITSET || end > header_->indexOffset || !isValid(NetworkView(nbWires(), record, packsComparators()))) {
+            throw std::runtime_error("Corrupted network file: " + path_);
+        }
+    }
+}
+
+bool MappedNetworkFile::isValid(const NetworkView& view) {
+    int n = view.nbWires();
+    for (int i = 0; i < view.nbComparators(); ++i) {
+        if (view.wire0(i) >= n || view.wire1(i) >= n) return false;
+    }
+
+    // increasing values below 2^n, as many as outSize
+    uint64_t nbValues = uint64_t(1) << n;
+    if (view.outSize() < 0 || uint64_t(view.outSize()) > nbValues) return false;
+    int64_t previous = -1;
+    int count = 0;
+    bool valid = true;
+    view.forEachValue([&](int value) {
+        valid = valid && value > previous && uint64_t(value) < nbValues;
+        previous = value;
+        count++;
+        });
+    return valid && count == view.outSize();
+}
+
+NetworkView MappedNetworkFile::operator[](size_t i) const {
+    return NetworkView(nbWires(), reinterpret_cast<const NetworkFile::Record*>(data_ + index_[i]), packsComparators());
+}
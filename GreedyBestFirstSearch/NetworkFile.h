@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Network.h"
+#include "BitOps.h"
+#include "PackedComparator.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Binary file of networks with their output sets.
+//
+// Layout, little-endian, every record aligned on 8 bytes:
+//   header    magic "SNBF", version, number of wires, number of networks and
+//             offset of the index
+//   records   number of comparators, output encoding, output size, the
+//             comparators, then the output set, either as its sorted values
+//             (uint32) or as a bitset over all 2^n values (uint64 words),
+//             whichever is smaller
+//   index     offset of each record (uint64)
+//
+// The comparators are (wire0, wire1) byte pairs in version 1. Version 2
+// packs each of them in a single PackedComparator byte when there are at
+// most 16 wires. The writer produces version 2; the reader accepts both.
+class NetworkFile {
+public:
+    static constexpr char MAGIC[4] = { 'S', 'N', 'B', 'F' };
+    static constexpr uint16_t VERSION = 2;
+
+    enum Encoding : uint8_t { SORTED_VALUES = 0, BITSET = 1 };
+
+    struct Header {
+        char magic[4];
+        uint16_t version;
+        uint8_t nbWires;
+        uint8_t reserved0;
+        uint32_t reserved1;
+        uint32_t reserved2;
+        uint64_t count;
+        uint64_t indexOffset;
+    };
+
+    struct Record {
+        uint8_t nbComparators;
+        uint8_t encoding;
+        uint16_t reserved;
+        uint32_t outSize;
+        // followed by the comparators and the output set
+    };
+
+    static void write(const std::string& path, int nbWires, const std::vector<std::unique_ptr<Network>>& list);
+
+    static bool packsComparators(uint16_t version, int nbWires) {
+        return version >= 2 && PackedComparator::fits(nbWires);
+    }
+};
+
+// Network stored in a mapped NetworkFile, read in place. Valid as long as
+// the file stays open.
+class NetworkView {
+public:
+    NetworkView(int nbWires, const NetworkFile::Record* record, bool packed);
+
+    int nbWires() const { return nbWires_; }
+    int nbComparators() const { return record_->nbComparators; }
+    int wire0(int i) const { return packed_ ? PackedComparator(comparators_[i]).wire0() : comparators_[2 * i]; }
+    int wire1(int i) const { return packed_ ? PackedComparator(comparators_[i]).wire1() : comparators_[2 * i + 1]; }
+
+    int outSize() const { return static_cast<int>(record_->outSize); }
+    bool contains(int value) const;
+    // Calls f on each output value, in increasing order.
+    template <typename Func>
+    void forEachValue(Func f) const;
+
+    // Builds the full network, output set included.
+    std::unique_ptr<Network> toNetwork() const;
+
+private:
+    int nbWires_;
+    bool packed_;
+    const NetworkFile::Record* record_;
+    const uint8_t* comparators_;
+    const void* outputs_;
+};
+
+// Read-only memory mapping of a NetworkFile.
+class MappedNetworkFile {
+public:
+    // Throws std::runtime_error if the file cannot be mapped or is not a
+    // valid network file.
+    explicit MappedNetworkFile(const std::string& path);
+    ~MappedNetworkFile();
+
+    MappedNetworkFile(const MappedNetworkFile&) = delete;
+    MappedNetworkFile& operator=(const MappedNetworkFile&) = delete;
+
+    int nbWires() const { return header_->nbWires; }
+    size_t size() const { return static_cast<size_t>(header_->count); }
+    bool packsComparators() const { return NetworkFile::packsComparators(header_->version, nbWires()); }
+    NetworkView operator[](size_t i) const;
+
+private:
+    std::string path_;
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+    const NetworkFile::Header* header_ = nullptr;
+    const uint64_t* index_ = nullptr;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+
+    void validate();
+    void unmap();
+    // Whether the comparators and output values of the record are in range.
+    static bool isValid(const NetworkView& view);
+};
+
+template <typename Func>
+void NetworkView::forEachValue(Func f) const {
+    if (record_->encoding == NetworkFile::SORTED_VALUES) {
+        const uint32_t* values = static_cast<const uint32_t*>(outputs_);
+        for (uint32_t i = 0; i < record_->outSize; ++i) {
+            f(static_cast<int>(values[i]));
+        }
+        return;
+    }
+
+    const uint64_t* words = static_cast<const uint64_t*>(outputs_);
+    size_t nbWords = ((size_t(1) << nbWires_) + 63) / 64;
+    for (size_t w = 0; w < nbWords; ++w) {
+        for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+            f(static_cast<int>(w * 64 + BitOps::ctz(bits)));
+        }
+    }
+}
@@ -1,69 +1,192 @@
 ﻿#include "NetworkGenerator.h"
 #include "NetworkExpander.h"
 #include "NetworkRemover.h"
+#include "OutputCertificate.h"
 #include <iostream>
 #include <cmath>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 
 
 NetworkGenerator::NetworkGenerator(int nbWires, int toSize)
     : nbWires_(nbWires), fromSize_(toSize), toSize_(toSize),
-    prefix_(nullptr), suffix_(nullptr) {
+    level_(nbWires, Config::getLevelBudget(), spillFile(nbWires)),
+    seed_(Config::getSeed()), prefix_(nullptr), suffix_(nullptr) {
 
-    list_.reserve(1000);
     int maxOutSize = static_cast<int>(std::pow(2, nbWires_));
-    list_.emplace_back(std::make_unique<RuntimeNetwork>(nbWires_));
+    LevelStore::Chunk level;
+    level.emplace_back(std::make_unique<RuntimeNetwork>(nbWires_));
+    level_.assign(std::move(level));
 
     Statistics::nbWires = nbWires_;
     workList_ = std::make_unique<WorkingList>(nbWires_, maxOutSize);
-    threadPool_ = std::make_unique<FastThreadPool>(Config::getNbThreads());
+    createScheduler();
+    createCheckpointWriter();
 }
 
 NetworkGenerator::NetworkGenerator(int nbWires, int fromSize, int toSize, Network* prefix, Network* suffix)
     : nbWires_(nbWires), fromSize_(fromSize), toSize_(toSize),
-    prefix_(prefix), suffix_(suffix) {
+    level_(nbWires, Config::getLevelBudget(), spillFile(nbWires)),
+    seed_(Config::getSeed()), prefix_(prefix), suffix_(suffix) {
 
-    list_.reserve(1000);
     int maxOutSize = 0;
+    LevelStore::Chunk level;
 
     if (fromSize_ == 1) {
-        list_.emplace_back(std::make_unique<RuntimeNetwork>(nbWires_));
+        level.emplace_back(std::make_unique<RuntimeNetwork>(nbWires_));
         maxOutSize = static_cast<int>(std::pow(2, nbWires_));
     }
     else if (!prefix_) {
         auto nets = NetworkIO::read(OUT_DIR_, nbWires_, fromSize_ - 1);
         for (auto& net : nets) {
-            list_.emplace_back(std::make_unique<RuntimeNetwork>(net.get()));
+            level.emplace_back(std::make_unique<RuntimeNetwork>(net.get()));
             maxOutSize = std::max(maxOutSize, net->outputSet()->size());
         }
     }
     else {
         std::cout << "Using prefix: " << prefix_->toString() << std::endl;
-        list_.emplace_back(std::make_unique<RuntimeNetwork>(prefix_));
+        level.emplace_back(std::make_unique<RuntimeNetwork>(prefix_));
         maxOutSize = prefix_->outputSet()->size();
     }
+    level_.assign(std::move(level));
 
     Statistics::nbWires = nbWires_;
     workList_ = std::make_unique<WorkingList>(nbWires_, maxOutSize);
-    threadPool_ = std::make_unique<FastThreadPool>(Config::getNbThreads());
+    createScheduler();
+    createCheckpointWriter();
 }
 
 NetworkGenerator::~NetworkGenerator() = default;
 
+std::string NetworkGenerator::spillFile(int nbWires) {
+    return OUT_DIR_ + "/level_" + std::to_string(nbWires) + ".spill";
+}
+
+void NetworkGenerator::createScheduler() {
+    scheduler_.reset(Scheduler::create(Config::getSchedulerImpl(), Config::getNbThreads()));
+    if (!scheduler_) {
+        std::cerr << "Unknown scheduler: " << Config::getSchedulerImpl() << ", using FastThreadPool\n";
+        scheduler_.reset(Scheduler::create("FastThreadPool", Config::getNbThreads()));
+    }
+}
+
+void NetworkGenerator::createCheckpointWriter() {
+    if (!Config::getCheckpointDir().empty()) {
+        checkpoints_ = std::make_unique<CheckpointWriter>(Config::getCheckpointDir());
+    }
+}
+
+uint64_t NetworkGenerator::expanderSeed(int size, size_t parent) const {
+    // splitmix64 of the seed, the level and the parent: a resumed run draws the same numbers
+    uint64_t z = seed_ + 0x9e3779b97f4a7c15ULL * (1 + parent + (static_cast<uint64_t>(size) << 40));
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void NetworkGenerator::saveLevel(int size) {
+    Checkpoint checkpoint;
+    checkpoint.nbWires = nbWires_;
+    checkpoint.size = size;
+    checkpoint.seed = seed_;
+    checkpoint.parents = level_.size();
+    std::vector<char> progress = checkpoint.serialize();
+
+    // the level file first: until the progress refers to it, the previous one is still in use
+    std::string dir = checkpoints_->dir();
+    checkpoints_->submit([this, dir, size, progress]() {
+        std::string file = Checkpoint::levelFile(dir, nbWires_, size);
+        level_.save(file + ".tmp");
+        std::filesystem::rename(file + ".tmp", file);
+        CheckpointWriter::writeFile(Checkpoint::progressFile(dir, nbWires_), progress);
+        std::remove(Checkpoint::levelFile(dir, nbWires_, size - 1).c_str());
+        });
+    lastCheckpoint_ = Statistics::currentTimeMillis();
+}
+
+void NetworkGenerator::saveProgress(int size, size_t cursor) {
+    auto checkpoint = std::make_shared<Checkpoint>();
+    checkpoint->nbWires = nbWires_;
+    checkpoint->size = size;
+    checkpoint->seed = seed_;
+    checkpoint->parents = level_.size();
+    checkpoint->cursor = cursor;
+    checkpoint->checkedNetworks = checkedNetworks_;
+
+    // no expander is running: the working list can be read without a guard
+    for (int i = workList_->first(); i <= workList_->last(); ++i) {
+        int n = workList_->networkList(i)->size();
+        for (int j = 0; j < n; ++j) {
+            RuntimeNetwork* net = workList_->getNetwork(i, j);
+            if (net == nullptr || net->isDead()) continue;
+
+            std::vector<uint8_t> comparators;
+            for (const auto& c : net->chain().toVector()) {
+                comparators.push_back(static_cast<uint8_t>(c.getWire0()));
+                comparators.push_back(static_cast<uint8_t>(c.getWire1()));
+            }
+            checkpoint->networks.push_back(std::move(comparators));
+        }
+    }
+    checkpoint->outputs = workList_->claimedOutputs();
+
+    std::string file = Checkpoint::progressFile(checkpoints_->dir(), nbWires_);
+    checkpoints_->submit([file, checkpoint]() {
+        CheckpointWriter::writeFile(file, checkpoint->serialize());
+        });
+    lastCheckpoint_ = Statistics::currentTimeMillis();
+}
+
+void NetworkGenerator::restore(const Checkpoint& checkpoint) {
+    for (const auto& comparators : checkpoint.networks) {
+        auto net = std::make_unique<RuntimeNetwork>(nbWires_);
+        for (size_t c = 0; c + 1 < comparators.size(); c += 2) {
+            net->addComparator(comparators[c], comparators[c + 1]);
+        }
+        if (isSubsumptionEnabled()) {
+            net->certificate = OutputCertificate::of(*net->outputSet());
+        }
+        workList_->addNetwork(std::move(net));
+    }
+    for (const OutputHash& hash : checkpoint.outputs) {
+        workList_->claimOutput(hash);
+    }
+    checkedNetworks_ = checkpoint.checkedNetworks;
+}
+
 std::vector<std::unique_ptr<Network>> NetworkGenerator::createAll() {
-    for (int size = fromSize_; size <= toSize_; ++size) {
+    int fromSize = fromSize_;
+    if (checkpoints_ && Config::isResumeEnabled()) {
+        resume_ = Checkpoint::read(checkpoints_->dir(), nbWires_);
+    }
+    if (resume_) {
+        fromSize = resume_->size;
+        seed_ = resume_->seed;
+        level_.load(Checkpoint::levelFile(checkpoints_->dir(), nbWires_, fromSize), resume_->parents);
+        workList_ = std::make_unique<WorkingList>(nbWires_, 1 << nbWires_);
+        std::cout << "Resuming level " << fromSize << " after " << resume_->cursor
+            << " of " << resume_->parents << " networks" << std::endl;
+    }
+
+    for (int size = fromSize; size <= toSize_; ++size) {
         createAll(size);
     }
+    if (checkpoints_) {
+        checkpoints_->wait();
+    }
 
     if (monitor_) {
         monitor_->setRunning(false);
     }
 
     std::vector<std::unique_ptr<Network>> result;
-    result.reserve(list_.size());
-    for (auto& net : list_) {
-        result.emplace_back(std::make_unique<Network>(*net));
-    }
+    result.reserve(level_.size());
+    level_.forEachChunk([&](LevelStore::Chunk& chunk) {
+        for (auto& net : chunk) {
+            result.emplace_back(std::make_unique<Network>(*net));
+        }
+        });
     return result;
 }
 
@@ -79,40 +202,59 @@ void NetworkGenerator::createAll(int size) {
     workList_->clear();
     RuntimeNetwork::resetIds();
 
-    totalNetworks_ = static_cast<long>(list_.size()) * nbWires_ * (nbWires_ - 1) / 2;
+    totalNetworks_ = static_cast<long>(level_.size()) * nbWires_ * (nbWires_ - 1) / 2;
     checkedNetworks_ = 0;
 
+    size_t cursor = 0;
+    if (resume_) {
+        restore(*resume_);
+        cursor = resume_->cursor;
+        resume_.reset();
+    }
+    else if (checkpoints_) {
+        saveLevel(size);
+    }
+
     try {
         //std::cout << "[DEBUG] Submitting tasks to ThreadPool...\n";
 
+        monitor_ = std::make_unique<MonitorThread>(this);
+        monitor_->start();
+
         auto submitStart = clock::now();
-        for (auto& net : list_) {
-            if (net->isEmpty()) {
-                workList_->addNetwork(std::make_unique<RuntimeNetwork>(net.get(), 0, 1));
-                ++checkedNetworks_;
-                continue;
+        // the expanders of a chunk point into it, so each chunk is drained before the next is read;
+        // with checkpoints, it is drained by batches, a checkpoint being possible after each
+        size_t parent = 0;
+        long long interval = 1000LL * Config::getCheckpointInterval();
+        level_.forEachChunk([&](LevelStore::Chunk& chunk) {
+            size_t batch = checkpoints_ ? CHECKPOINT_BATCH : chunk.size();
+            for (size_t from = 0; from < chunk.size(); from += batch) {
+                size_t to = std::min(chunk.size(), from + batch);
+                for (size_t i = from; i < to; ++i, ++parent) {
+                    if (parent < cursor) continue;
+
+                    RuntimeNetwork* net = chunk[i].get();
+                    if (net->isEmpty()) {
+                        workList_->addNetwork(std::make_unique<RuntimeNetwork>(net, 0, 1));
+                        ++checkedNetworks_;
+                        continue;
+                    }
+                    scheduler_->submit(NetworkExpander(this, net, expanderSeed(size, parent)));
+                }
+                scheduler_->wait();
+
+                if (checkpoints_ && parent > cursor && Statistics::currentTimeMillis() - lastCheckpoint_ >= interval) {
+                    saveProgress(size, parent);
+                }
             }
-            threadPool_->submit(NetworkExpander(this, net.get()));
-        }
+            });
         auto submitEnd = clock::now();
         /*
-        std::cout << "[DEBUG] Submitting done. Took "
+        std::cout << "[DEBUG] Expanding done. Took "
             << std::chrono::duration_cast<std::chrono::milliseconds>(submitEnd - submitStart).count()
             << " ms.\n";
         */
 
-        monitor_ = std::make_unique<MonitorThread>(this);
-        monitor_->start();
-
-        auto waitStart = clock::now();
-        threadPool_->wait();
-        auto waitEnd = clock::now();
-        /*
-        std::cout << "[DEBUG] ThreadPool wait() done. Took "
-            << std::chrono::duration_cast<std::chrono::milliseconds>(waitEnd - waitStart).count()
-            << " ms.\n";
-        */
-
         if (monitor_) {
             monitor_->setRunning(false);
         }
@@ -126,46 +268,55 @@ void NetworkGenerator::createAll(int size) {
             << " ms.\n";
         */
 
-        list_ = workList_->joinLists();
+        auto survivors = workList_->joinLists();
+        if (survivors.size() > static_cast<size_t>(WORKING_LIST_LIMIT_)) {
+            std::cout << "Trimming from " << survivors.size() << std::endl;
+            survivors.resize(WORKING_LIST_LIMIT_);
+        }
+        if (checkpoints_) {
+            checkpoints_->wait();  // may still be saving the level
+        }
+        level_.assign(std::move(survivors));
     }
     catch (const std::exception& e) {
         std::cerr << "Exception during createAll: " << e.what() << std::endl;
         std::exit(EXIT_FAILURE);
     }
 
-    if (list_.size() > static_cast<size_t>(WORKING_LIST_LIMIT_)) {
-        std::cout << "Trimming from " << list_.size() << std::endl;
-        list_.resize(WORKING_LIST_LIMIT_);
-    }
-
     long t1 = Statistics::currentTimeMillis();
     Statistics::runningTime = t1 - t0;
     Statistics::usedMemory = Statistics::currentMemoryUsage();
-    Statistics::nbNetworks = static_cast<int>(list_.size());
-
-    bool foundSorting = false;
-    double bestFitness = 1.0;
-    for (const auto& net : list_) {
-        double fitness = net->computeFitness();
-        bestFitness = std::min(bestFitness, fitness);
-        if (net->isSorting()) foundSorting = true;
-    }
+    Statistics::nbNetworks = static_cast<int>(level_.size());
 
     std::string baseName = "statistics_" + std::to_string(nbWires_) + "-" + std::to_string(size);
-    std::string statsFile = "results/" + baseName + "_run" + std::to_string(runIndex_) + ".txt";
+    std::string statsFile = STATS_DIR_ + "/" + baseName + "_run" + std::to_string(runIndex_) + ".txt";
 
     std::ofstream out(statsFile);
     Statistics::print();
     if (out.is_open()) {
         Statistics::print(out);
+    }
+    else {
+        std::cerr << "Could not open file " << statsFile << " for writing statistics.\n";
+    }
+
+    // a single pass, as a spilled level is read back from disk
+    bool foundSorting = false;
+    double bestFitness = 1.0;
+    level_.forEachChunk([&](LevelStore::Chunk& chunk) {
+        for (const auto& net : chunk) {
+            double fitness = net->computeFitness();
+            bestFitness = std::min(bestFitness, fitness);
+            bool sorting = net->isSorting();
+            if (sorting) foundSorting = true;
+            if (!out.is_open()) continue;
 
-        for (const auto& net : list_) {
             out << "Network with " << net->size()
                 << " comparators, fitness: "
-                << net->computeFitness() << "\n"
+                << fitness << "\n"
                 << net->toString() << "\n";
 
-            if (net->isSorting()) {
+            if (sorting) {
                 out << "Sorting network.\n";
             }
             else {
@@ -174,12 +325,8 @@ void NetworkGenerator::createAll(int size) {
 
             out << "\n";
         }
-
-        out.close();
-    }
-    else {
-        std::cerr << "Could not open file " << statsFile << " for writing statistics.\n";
-    }
+        });
+    out.close();
     /*
     if (Statistics::ENABLED) {
         NetworkIO::writeSubsumptions(nbWires_, size);
@@ -209,18 +356,16 @@ void NetworkGenerator::createAll(int size) {
 void NetworkGenerator::finalCheck() {
     long long start = Statistics::currentTimeMillis();
 
-    workList_->removeAllDead();
-
     for (int i = workList_->first(); i <= workList_->last(); ++i) {
-        auto& networks = workList_->networks(i);
-        for (auto& net : networks) {
-            threadPool_->submit(NetworkRemover(this, net.get()));
+        int n = workList_->networkList(i)->size();
+        for (int j = 0; j < n; ++j) {
+            if (workList_->getNetwork(i, j) != nullptr) {
+                scheduler_->submit(NetworkRemover(this, i, j));
+            }
         }
     }
 
-    threadPool_->wait();
-
-    workList_->removeAllDead();
+    scheduler_->wait();
 
 
     Statistics::finalChecksTime += Statistics::currentTimeMillis() - start;
@@ -255,6 +400,14 @@ void NetworkGenerator::setOutDir(const std::string& outDir) {
     OUT_DIR_ = outDir;
 }
 
+const std::string& NetworkGenerator::getStatsDir() {
+    return STATS_DIR_;
+}
+
+void NetworkGenerator::setStatsDir(const std::string& statsDir) {
+    STATS_DIR_ = statsDir;
+}
+
 void NetworkGenerator::setRunningMonitor(bool running) {
     if (monitor_) {
         monitor_->setRunning(running);
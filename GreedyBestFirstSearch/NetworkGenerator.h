@@ -2,16 +2,17 @@
 
 #include "RuntimeNetwork.h"
 #include "WorkingList.h"
+#include "LevelStore.h"
+#include "Checkpoint.h"
 #include "MonitorThread.h"
 #include "NetworkIO.h"
 #include "Statistics.h"
 #include "Config.h"
-#include "FastThreadPool.h"
+#include "Scheduler.h"
 #include <vector>
 #include <memory>
 #include <thread>
 #include <atomic>
-#include <shared_mutex>
 
 class NetworkGenerator {
 private:
@@ -19,12 +20,14 @@ private:
     const int nbWires_;
     const int fromSize_;
     const int toSize_;
-    std::vector<std::unique_ptr<RuntimeNetwork>> list_;
-    std::unique_ptr<FastThreadPool> threadPool_;
-    std::shared_mutex workLock_;
-    std::mutex cleanupLock_;
+    LevelStore level_;
+    std::unique_ptr<Scheduler> scheduler_;
     std::unique_ptr<WorkingList> workList_;
     std::unique_ptr<MonitorThread> monitor_;
+    std::unique_ptr<CheckpointWriter> checkpoints_;
+    std::unique_ptr<Checkpoint> resume_;
+    long long lastCheckpoint_ = 0;
+    uint64_t seed_;
 
     Network* prefix_;
     Network* suffix_;
@@ -34,10 +37,20 @@ private:
 
     static inline bool SUBSUMPTION_ENABLED_ = false;
     static inline std::string OUT_DIR_ = "results2";
+    static inline std::string STATS_DIR_ = "results";
     static inline int WORKING_LIST_LIMIT_ = 500;
+    // parents expanded between two opportunities for a checkpoint
+    static constexpr size_t CHECKPOINT_BATCH = 256;
 
     void createAll(int size);
     void finalCheck();
+    void createScheduler();
+    void createCheckpointWriter();
+    void saveLevel(int size);
+    void saveProgress(int size, size_t cursor);
+    void restore(const Checkpoint& checkpoint);
+    uint64_t expanderSeed(int size, size_t parent) const;
+    static std::string spillFile(int nbWires);
 
 public:
     NetworkGenerator(int nbWires, int toSize);
@@ -53,12 +66,12 @@ public:
     static void setWorkingListLimit(int limit);
     static const std::string& getOutDir();
     static void setOutDir(const std::string& outDir);
+    // Directory of the statistics written after each level.
+    static const std::string& getStatsDir();
+    static void setStatsDir(const std::string& statsDir);
 
     WorkingList* getWorkList() const { return workList_.get(); }
-    std::shared_mutex& getWorkLock() { return workLock_; }
-    std::mutex& getCleanupLock() { return cleanupLock_; }
-    bool tryCleanupLock() { return cleanupLock_.try_lock(); }
-    void unlockCleanup() { cleanupLock_.unlock(); }
+    Scheduler* getScheduler() const { return scheduler_.get(); }
     void incrementCheckedNetworks() { checkedNetworks_++; }
 
     long getTotalNetworks() const { return totalNetworks_; }
@@ -1,12 +1,21 @@
 ﻿#include "NetworkIO.h"
+#include "Config.h"
+#include "NetworkParser.h"
+#include "Scheduler.h"
 #include <fstream>
 #include <iostream>
 #include <filesystem>
 #include <sstream>
+#include <algorithm>
 #include <iostream>
 
 namespace fs = std::filesystem;
 
+namespace {
+    // smaller text files are parsed on the calling thread
+    constexpr size_t PARALLEL_PARSE_BYTES = 1 << 20;
+}
+
 void NetworkIO::ensureDirectoryExists(const std::string& path) {
     if (!fs::exists(path)) {
         fs::create_directories(path);
@@ -17,9 +26,22 @@ void NetworkIO::write(int nbWires, int size, const std::vector<std::unique_ptr<N
     write("results", nbWires, size, list);
 }
 
+std::string NetworkIO::path(const std::string& dir, const std::string& file, int nbWires, int nbComparators, const std::string& extension) {
+    return dir + "/" + file + "_" + std::to_string(nbWires) + "-" + std::to_string(nbComparators) + extension;
+}
+
 void NetworkIO::write(const std::string& dir, int nbWires, int size, const std::vector<std::unique_ptr<Network>>& list) {
     ensureDirectoryExists(dir);
-    std::ofstream out(dir + "/networks_" + std::to_string(nbWires) + "-" + std::to_string(size) + ".txt");
+    NetworkFile::write(path(dir, "networks", nbWires, size, ".bin"), nbWires, list);
+
+    if (Config::isTextExportEnabled()) {
+        writeText(dir, nbWires, size, list);
+    }
+}
+
+void NetworkIO::writeText(const std::string& dir, int nbWires, int size, const std::vector<std::unique_ptr<Network>>& list) {
+    ensureDirectoryExists(dir);
+    std::ofstream out(path(dir, "networks", nbWires, size, ".txt"));
     if (!out.is_open()) {
         std::cerr << "Cannot open file for writing networks.\n";
         return;
@@ -57,37 +79,60 @@ std::vector<std::unique_ptr<Network>> NetworkIO::read(const std::string& dir, in
     return read(dir, "networks", nbWires, nbComparators, limit);
 }
 
+std::unique_ptr<MappedNetworkFile> NetworkIO::open(const std::string& dir, int nbWires, int nbComparators) {
+    return map(path(dir, "networks", nbWires, nbComparators, ".bin"), nbWires);
+}
+
+std::unique_ptr<MappedNetworkFile> NetworkIO::map(const std::string& filename, int nbWires) {
+    if (!fs::exists(filename)) {
+        return nullptr;
+    }
+
+    auto file = std::make_unique<MappedNetworkFile>(filename);
+    if (file->nbWires() != nbWires) {
+        throw std::runtime_error("Unexpected number of wires in " + filename);
+    }
+    return file;
+}
+
 std::vector<std::unique_ptr<Network>> NetworkIO::read(const std::string& dir, const std::string& file, int nbWires, int nbComparators, int limit) {
     std::vector<std::unique_ptr<Network>> list;
-    std::string filename = dir + "/" + file + "_" + std::to_string(nbWires) + "-" + std::to_string(nbComparators) + ".txt";
+
+    std::string binary = path(dir, file, nbWires, nbComparators, ".bin");
+    if (auto mapped = map(binary, nbWires)) {
+        std::cout << "Reading from " << binary << " ... ";
+        size_t count = std::min(mapped->size(), static_cast<size_t>(limit));
+        list.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            list.push_back((*mapped)[i].toNetwork());
+        }
+        std::cout << list.size() << " networks" << std::endl;
+        return list;
+    }
+
+    std::string filename = path(dir, file, nbWires, nbComparators, ".txt");
 
     if (!fs::exists(filename)) {
         std::cout << "File " << filename << " does not exist..." << std::endl;
         return list;
     }
 
-    std::ifstream in(filename);
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
     if (!in.is_open()) {
         throw std::runtime_error("Unable to open file: " + filename);
     }
 
     std::cout << "Reading from " << filename << " ... ";
 
-    std::string line;
-    std::unique_ptr<Network> net = nullptr;
-    while (std::getline(in, line)) {
-        if (list.size() >= static_cast<size_t>(limit)) break;
+    std::string text(static_cast<size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    in.read(text.data(), text.size());
 
-        if (!line.empty() && line[0] == '[') {
-            net = std::make_unique<Network>(nbWires);
-            net->parse(line);
-            list.push_back(std::move(net));
-        }
-        else if (!line.empty() && line[0] == '{' && !list.empty()) {
-            list.back()->parseOutput(line);
-            net = nullptr;
-        }
+    std::unique_ptr<Scheduler> scheduler;
+    if (text.size() >= PARALLEL_PARSE_BYTES) {
+        scheduler.reset(Scheduler::create(Config::getSchedulerImpl(), Config::getNbThreads()));
     }
+    list = NetworkParser::parse(text, nbWires, static_cast<size_t>(limit), scheduler.get(), 4 * Config::getNbThreads());
 
     std::cout << list.size() << " networks" << std::endl;
     return list;
@@ -99,6 +144,26 @@ std::unique_ptr<Network> NetworkIO::readSingle(const std::string& dir, const std
     return std::move(nets.front());
 }
 
+std::vector<std::unique_ptr<Network>> NetworkIO::readStatistics(const std::string& dir, int nbWires, int nbComparators, int runIndex) {
+    std::vector<std::unique_ptr<Network>> list;
+    std::string filename = dir + "/statistics_" + std::to_string(nbWires) + "-" + std::to_string(nbComparators) + "_run" + std::to_string(runIndex) + ".txt";
+
+    std::ifstream in(filename);
+    if (!in.is_open()) {
+        return list;
+    }
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[0] == '[') {
+            auto net = std::make_unique<Network>(nbWires);
+            net->parse(line);
+            list.push_back(std::move(net));
+        }
+    }
+    return list;
+}
+
 void NetworkIO::writeSubsumptions(int nbWires, int nbComparators) {
     ensureDirectoryExists("results");
     std::ofstream out("results/subsumptions_" + std::to_string(nbWires) + "-" + std::to_string(nbComparators) + ".txt");
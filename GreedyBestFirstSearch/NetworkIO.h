@@ -2,6 +2,7 @@
 
 #include "Network.h"
 #include "Statistics.h"
+#include "NetworkFile.h"
 #include <vector>
 #include <memory>
 #include <string>
@@ -11,8 +12,11 @@ public:
     static void ensureDirectoryExists(const std::string& path);
     static void write(int nbWires, int size, const std::vector<std::unique_ptr<Network>>& list);
 
+    // Writes the binary file, and the text file too if text export is enabled.
     static void write(const std::string& dir, int nbWires, int size, const std::vector<std::unique_ptr<Network>>& list);
 
+    static void writeText(const std::string& dir, int nbWires, int size, const std::vector<std::unique_ptr<Network>>& list);
+
     static void writeOptimum(const std::string& dir, const Network& net);
 
     static void write(const std::string& dir, const std::string& file, const Network& net);
@@ -23,11 +27,21 @@ public:
 
     static std::vector<std::unique_ptr<Network>> read(const std::string& dir, int nbWires, int nbComparators, int limit);
 
+    // Reads the binary file if there is one, the text file otherwise.
     static std::vector<std::unique_ptr<Network>> read(const std::string& dir, const std::string& file, int nbWires, int nbComparators, int limit);
 
+    // Maps the binary file of a level for reading in place; nullptr if there is none.
+    static std::unique_ptr<MappedNetworkFile> open(const std::string& dir, int nbWires, int nbComparators);
+
     static std::unique_ptr<Network> readSingle(const std::string& dir, const std::string& file, int nbWires, int nbComparators);
 
+    static std::vector<std::unique_ptr<Network>> readStatistics(const std::string& dir, int nbWires, int nbComparators, int runIndex);
+
     static void writeSubsumptions(int nbWires, int nbComparators);
 
     static void writeFails(int nbWires, int nbComparators);
+
+private:
+    static std::unique_ptr<MappedNetworkFile> map(const std::string& filename, int nbWires);
+    static std::string path(const std::string& dir, const std::string& file, int nbWires, int nbComparators, const std::string& extension);
 };
@@ -1,61 +1,87 @@
 ﻿#include "NetworkList.h"
+#include "BitOps.h"
+#include <stdexcept>
 
-NetworkList::NetworkList() {
-    networks_.reserve(capacity_);
-}
-
-void NetworkList::clear() {
-    std::lock_guard<std::mutex> lock(mtx_);
-    networks_.clear();
+NetworkList::Segment::Segment(int length, int nbSizeWords)
+    : slots(new Slot[length]), ids(new int[length]), fitness(new double[length]),
+    sizes(new uint64_t[static_cast<size_t>(length) * nbSizeWords]) {
+    for (int j = 0; j < length; ++j) {
+        slots[j].store(nullptr, std::memory_order_relaxed);
+    }
 }
 
-void NetworkList::addNetwork(std::unique_ptr<RuntimeNetwork> net) {
-    std::lock_guard<std::mutex> lock(mtx_);
-    networks_.push_back(std::move(net));
+NetworkList::NetworkList(int nbSizeWords) : nbSizeWords_(nbSizeWords) {
+    for (auto& segment : segments_) {
+        segment.store(nullptr, std::memory_order_relaxed);
+    }
 }
 
-/*
-void NetworkList::remove(RuntimeNetwork* net) {
-    std::lock_guard<std::mutex> lock(mtx_);
-    networks_.erase(
-        std::remove_if(networks_.begin(), networks_.end(),
-            [net](const std::unique_ptr<RuntimeNetwork>& ptr) { return ptr.get() == net; }),
-        networks_.end()
-    );
+NetworkList::~NetworkList() {
+    clear();
+    for (auto& segment : segments_) {
+        delete segment.load();
+    }
 }
 
-*/
+NetworkList::Segment* NetworkList::segment(int i, int& offset, bool create) const {
+    // segment k holds FIRST_SEGMENT << k slots, starting at index FIRST_SEGMENT * (2^k - 1)
+    int k = BitOps::highestBit(static_cast<uint64_t>(i / FIRST_SEGMENT + 1));
+    if (k >= MAX_SEGMENTS) {
+        throw std::out_of_range("NetworkList capacity exceeded.");
+    }
+    offset = i - FIRST_SEGMENT * ((1 << k) - 1);
 
-void NetworkList::remove(RuntimeNetwork* net) {
-    std::lock_guard<std::mutex> lock(mtx_);
-    for (size_t i = 0; i < networks_.size(); ++i) {
-        if (networks_[i].get() == net) {
-            std::swap(networks_[i], networks_.back());
-            networks_.pop_back();
-            break;
+    Segment* segment = segments_[k].load(std::memory_order_acquire);
+    if (segment == nullptr && create) {
+        Segment* fresh = new Segment(FIRST_SEGMENT << k, nbSizeWords_);
+        if (segments_[k].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel)) {
+            segment = fresh;
+        }
+        else {
+            delete fresh;
         }
     }
+    return segment;
 }
 
-
-RuntimeNetwork* NetworkList::getNetwork(int i) const {
-    std::lock_guard<std::mutex> lock(mtx_);
-    return networks_[i].get();
+void NetworkList::clear() {
+    int n = size_.load();
+    for (int i = 0; i < n; ++i) {
+        delete release(i);
+    }
+    size_.store(0);
 }
 
-int NetworkList::size() const {
-    std::lock_guard<std::mutex> lock(mtx_);
-    return static_cast<int>(networks_.size());
+int NetworkList::addNetwork(std::unique_ptr<RuntimeNetwork> net) {
+    int i = size_.fetch_add(1);
+    int offset;
+    Segment* s = segment(i, offset, true);
+    net->index = i;
+
+    // the columns are published along with the slot
+    s->ids[offset] = net->getId();
+    s->fitness[offset] = net->computeFitness();
+    const OutputSignature& signature = net->outputSet()->signature();
+    uint64_t* sizes = s->sizes.get() + static_cast<size_t>(offset) * nbSizeWords_;
+    std::fill(sizes, sizes + nbSizeWords_, uint64_t(0));
+    std::copy(signature.sizeWords(), signature.sizeWords() + std::min(signature.nbSizeWords(), nbSizeWords_), sizes);
+
+    s->slots[offset].store(net.release(), std::memory_order_release);
+    return i;
 }
 
-std::vector<std::unique_ptr<RuntimeNetwork>>& NetworkList::getNetworks() {
-    return networks_;
+RuntimeNetwork* NetworkList::release(int i) {
+    int offset;
+    Segment* s = segment(i, offset, false);
+    return s ? s->slots[offset].exchange(nullptr) : nullptr;
 }
 
-int NetworkList::getCapacity() const {
-    return capacity_;
+RuntimeNetwork* NetworkList::getNetwork(int i) const {
+    int offset;
+    Segment* s = segment(i, offset, false);
+    return s ? s->slots[offset].load(std::memory_order_acquire) : nullptr;
 }
 
-void NetworkList::setCapacity(int capacity) {
-    capacity_ = capacity;
+int NetworkList::size() const {
+    return size_.load(std::memory_order_acquire);
 }
@@ -1,27 +1,92 @@
 ﻿#pragma once
 
 #include "RuntimeNetwork.h"
-#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
-#include <mutex>
 
+// Append-only list of networks with lock-free reads and appends.
+// Slots live in segments of doubling size that are never moved, so a
+// reader can scan up to size() while other threads append. A slot reads
+// as nullptr while its network is being published and after release().
+//
+// Beside its slots, a segment keeps columns filled in when a network is
+// published: its id, its fitness and the cluster-size lanes of its output
+// signature. forEach() streams through these arrays, so a scan only
+// dereferences the networks that these columns do not rule out.
 class NetworkList {
+public:
+    // A published network, as seen by forEach().
+    struct Entry {
+        int index;
+        int id;
+        double fitness;
+        const uint64_t* sizes;  // OutputSignature cluster-size lanes, nbSizeWords words
+        int nbSizeWords;
+        RuntimeNetwork* network;
+    };
+
 private:
-    std::vector<std::unique_ptr<RuntimeNetwork>> networks_;
-    mutable std::mutex mtx_;
-    int capacity_ = 10;
+    static constexpr int FIRST_SEGMENT = 64;
+    static constexpr int MAX_SEGMENTS = 24;
+
+    using Slot = std::atomic<RuntimeNetwork*>;
+
+    struct Segment {
+        Segment(int length, int nbSizeWords);
+
+        std::unique_ptr<Slot[]> slots;
+        std::unique_ptr<int[]> ids;
+        std::unique_ptr<double[]> fitness;
+        std::unique_ptr<uint64_t[]> sizes;
+    };
+
+    const int nbSizeWords_;
+    mutable std::atomic<Segment*> segments_[MAX_SEGMENTS];
+    std::atomic<int> size_{ 0 };
+
+    // The segment holding index i, and the offset of i in it.
+    Segment* segment(int i, int& offset, bool create) const;
 
 public:
-    NetworkList();
+    // nbSizeWords: OutputSignature::nbSizeWords() of the networks of the list.
+    explicit NetworkList(int nbSizeWords);
+    ~NetworkList();
+
+    NetworkList(const NetworkList&) = delete;
+    NetworkList& operator=(const NetworkList&) = delete;
 
+    // Deletes the networks still in the list; no other thread may use it meanwhile.
     void clear();
-    void addNetwork(std::unique_ptr<RuntimeNetwork> net);
-    void remove(RuntimeNetwork* net);
+    // Appends the network and returns its index.
+    int addNetwork(std::unique_ptr<RuntimeNetwork> net);
+    // Unlinks the network at index i and hands it back to the caller.
+    RuntimeNetwork* release(int i);
     RuntimeNetwork* getNetwork(int i) const;
     int size() const;
 
-    std::vector<std::unique_ptr<RuntimeNetwork>>& getNetworks();
-    int getCapacity() const;
-
-    void setCapacity(int capacity);
+    // Calls f(const Entry&) on each network of the list, in order, up to the
+    // current size; stops as soon as f returns false.
+    template <typename Func>
+    void forEach(Func f) const;
 };
+
+template <typename Func>
+void NetworkList::forEach(Func f) const {
+    int n = size();
+    for (int k = 0, start = 0; start < n; start += FIRST_SEGMENT << k, ++k) {
+        const Segment* segment = segments_[k].load(std::memory_order_acquire);
+        if (segment == nullptr) continue;
+
+        int length = std::min(n - start, FIRST_SEGMENT << k);
+        for (int j = 0; j < length; ++j) {
+            RuntimeNetwork* net = segment->slots[j].load(std::memory_order_acquire);
+            if (net == nullptr) continue;
+
+            Entry entry{ start + j, segment->ids[j], segment->fitness[j],
+                segment->sizes.get() + static_cast<size_t>(j) * nbSizeWords_, nbSizeWords_, net };
+            if (!f(entry)) return;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#include "NetworkParser.h"
+#include "Scheduler.h"
+#include <algorithm>
+
+namespace {
+    bool startsNetwork(std::string_view text, size_t pos) {
+        return text[pos] == '[' && (pos == 0 || text[pos - 1] == '\n');
+    }
+}
+
+std::vector<std::unique_ptr<Network>> NetworkParser::parse(std::string_view text, int nbWires, size_t limit,
+    Scheduler* scheduler, int nbChunks) {
+    std::vector<std::unique_ptr<Network>> list;
+    if (!scheduler || nbChunks <= 1) {
+        parseChunk(text, nbWires, limit, list);
+        return list;
+    }
+
+    // each chunk starts on a network line, so an output line stays with its network
+    std::vector<size_t> bounds{ 0 };
+    for (int c = 1; c < nbChunks; ++c) {
+        size_t pos = std::max(bounds.back(), text.size() * c / nbChunks);
+        while (pos < text.size() && !startsNetwork(text, pos)) {
+            size_t eol = text.find('\n', pos);
+            pos = eol == std::string_view::npos ? text.size() : eol + 1;
+        }
+        bounds.push_back(pos);
+    }
+    bounds.push_back(text.size());
+
+    struct ChunkTask {
+        std::string_view text;
+        int nbWires;
+        size_t limit;
+        std::vector<std::unique_ptr<Network>>* list;
+
+        void operator()() {
+            parseChunk(text, nbWires, limit, *list);
+        }
+    };
+
+    std::vector<std::vector<std::unique_ptr<Network>>> parts(nbChunks);
+    for (int c = 0; c < nbChunks; ++c) {
+        if (bounds[c] < bounds[c + 1]) {
+            scheduler->submit(ChunkTask{ text.substr(bounds[c], bounds[c + 1] - bounds[c]), nbWires, limit, &parts[c] });
+        }
+    }
+    scheduler->wait();
+
+    for (auto& part : parts) {
+        for (auto& net : part) {
+            if (list.size() >= limit) break;
+            list.push_back(std::move(net));
+        }
+    }
+    return list;
+}
+
+void NetworkParser::parseChunk(std::string_view text, int nbWires, size_t limit,
+    std::vector<std::unique_ptr<Network>>& list) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        std::string_view line = text.substr(pos, eol - pos);
+        pos = eol + 1;
+
+        if (line.empty()) continue;
+        if (line[0] == '[') {
+            if (list.size() >= limit) break;
+            auto net = std::make_unique<Network>(nbWires);
+            net->parse(line);
+            list.push_back(std::move(net));
+        }
+        else if (line[0] == '{' && !list.empty()) {
+            list.back()->parseOutput(line);
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Network.h"
+#include <charconv>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class Scheduler;
+
+// Parser of the text format of NetworkIO: a network per line as
+// "[(a,b);(c,d);...]", optionally followed by its output set as "{v,w,...}".
+//
+// Numbers are read in a single pass with std::from_chars, without regexes
+// or temporary strings. A whole file can be split into chunks that start
+// on a network line and are parsed in parallel.
+class NetworkParser {
+public:
+    // Calls f on each unsigned integer of text, in order.
+    template <typename Func>
+    static void forEachNumber(std::string_view text, Func f);
+
+    // The networks of text, at most limit of them, in order. Parsed in
+    // nbChunks chunks on the scheduler if there is one.
+    static std::vector<std::unique_ptr<Network>> parse(std::string_view text, int nbWires, size_t limit,
+        Scheduler* scheduler = nullptr, int nbChunks = 1);
+
+private:
+    static void parseChunk(std::string_view text, int nbWires, size_t limit,
+        std::vector<std::unique_ptr<Network>>& list);
+};
+
+template <typename Func>
+void NetworkParser::forEachNumber(std::string_view text, Func f) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        if (*p < '0' || *p > '9') {
+            ++p;
+            continue;
+        }
+        int value = 0;
+        p = std::from_chars(p, end, value).ptr;
+        f(value);
+    }
+}
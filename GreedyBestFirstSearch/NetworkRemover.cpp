@@ -1,46 +1,53 @@
 #include "NetworkRemover.h"
-#include <mutex>
+#include "Statistics.h"
 
-NetworkRemover::NetworkRemover(NetworkGenerator* generator, RuntimeNetwork* net)
-    : generator_(generator), net_(net), workList_(generator->getWorkList()) {}
+NetworkRemover::NetworkRemover(NetworkGenerator* generator, int outSize, int index)
+    : generator_(generator), workList_(generator->getWorkList()), outSize_(outSize), index_(index) {}
 
 int NetworkRemover::operator()() {
-    if (net_->dead) {
+    EpochManager::Guard guard(workList_->epochs());
+
+    RuntimeNetwork* net = workList_->getNetwork(outSize_, index_);
+    if (net == nullptr || net->dead) {
         return 0;
     }
 
     int removed = 0;
-    int first = net_->outSize;
+    int rejected = 0;
+    int first = net->outSize;
     int last = workList_->last();
+    const uint64_t* sizes = net->outputSet()->signature().sizeWords();
 
-    for (int i = first; i <= last; ++i) {
-        int n = workList_->networkList(i)->size();
-        for (int j = 0; j < n; ++j) {
-            RuntimeNetwork* other = workList_->getNetwork(i, j);
+    for (int i = first; i <= last && !net->dead; ++i) {
+        workList_->networkList(i)->forEach([&](const NetworkList::Entry& other) {
+            if (net->dead) {
+                return false;
+            }
 
-            if (net_->dead) {
-                return removed;
+            if (other.network == net || other.id <= net->checkedSubsumesId) {
+                return true;
             }
 
-            if (other == net_ || other->dead ||
-                (other->id <= net_->checkedSubsumesId) ||
-                (net_->id <= other->checkedSubsumedById)) {
-                continue;
+            // the cluster sizes of net must not exceed those of other
+            if (OutputSignature::sizesExceed(sizes, other.sizes, other.nbSizeWords)) {
+                rejected++;
+                return true;
             }
 
-            if (!net_->subsumes(other)) {
-                continue;
+            if (other.network->dead || net->id <= other.network->checkedSubsumedById) {
+                return true;
             }
 
-            {
-                std::lock_guard<std::recursive_mutex> lock(workList_->getMutex());
-                if (!net_->dead) {
-                    workList_->addDead(other);
-                    removed++;
-                }
+            if (net->subsumes(other.network) && workList_->kill(net, other.network)) {
+                removed++;
             }
-        }
+            return true;
+            });
     }
 
+    if (Statistics::ENABLED) {
+        Statistics::subTotal += rejected;
+        Statistics::subClusterSizeFail += rejected;
+    }
     return removed;
 }
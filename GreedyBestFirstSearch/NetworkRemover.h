@@ -7,11 +7,13 @@
 class NetworkRemover {
 private:
     NetworkGenerator* generator_;
-    RuntimeNetwork* net_;
     WorkingList* workList_;
+    // The network is looked up when the task runs: by then it may have been removed.
+    int outSize_;
+    int index_;
 
 public:
-    NetworkRemover(NetworkGenerator* generator, RuntimeNetwork* net);
+    NetworkRemover(NetworkGenerator* generator, int outSize, int index);
 
     int operator()();
     WorkingList* getWorkList() const { return workList_; }
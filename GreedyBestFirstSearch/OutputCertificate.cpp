@@ -0,0 +1,117 @@
+#include "OutputCertificate.h"
+#include "OutputSet.h"
+#include "BitOps.h"
+#include <algorithm>
+
+namespace {
+    inline uint64_t mix(uint64_t h, uint64_t x) {
+        h ^= x + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    int countDistinct(std::vector<uint64_t> colors) {
+        std::sort(colors.begin(), colors.end());
+        return static_cast<int>(std::unique(colors.begin(), colors.end()) - colors.begin());
+    }
+}
+
+uint64_t OutputCertificate::of(const OutputSet& outputSet) {
+    int n = outputSet.getNbWires();
+    const ValuesBitSet* bits = outputSet.bitValues();
+    const uint64_t* words = bits->words();
+
+    std::vector<int> values;
+    values.reserve(outputSet.size());
+    for (size_t w = 0; w < bits->nbWords(); ++w) {
+        for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+            values.push_back(static_cast<int>(w * 64 + BitOps::ctz(bits)));
+        }
+    }
+
+    // columns[wire] = the values having a 1 on that wire, as a bitset over their positions
+    int count = static_cast<int>(values.size());
+    int stride = (count + 63) / 64;
+    std::vector<uint64_t> columns(static_cast<size_t>(n) * stride, 0);
+    std::vector<int> ones(static_cast<size_t>(n) * (n + 1), 0);
+    for (int i = 0; i < count; ++i) {
+        int level = BitOps::popcount(values[i]);
+        for (int bits = values[i]; bits != 0; bits &= bits - 1) {
+            int wire = BitOps::ctz(bits);
+            columns[wire * stride + i / 64] |= uint64_t(1) << (i % 64);
+            ones[wire * (n + 1) + level]++;
+        }
+    }
+
+    std::vector<int> together(static_cast<size_t>(n) * n, 0);
+    for (int u = 0; u < n; ++u) {
+        for (int v = u + 1; v < n; ++v) {
+            int c = 0;
+            for (int w = 0; w < stride; ++w) {
+                c += BitOps::popcount(columns[u * stride + w] & columns[v * stride + w]);
+            }
+            together[u * n + v] = together[v * n + u] = c;
+        }
+    }
+
+    std::vector<uint64_t> colors(n), next(n);
+    for (int u = 0; u < n; ++u) {
+        uint64_t h = 0;
+        for (int level = 0; level <= n; ++level) {
+            h = mix(h, ones[u * (n + 1) + level]);
+        }
+        colors[u] = h;
+    }
+
+    std::vector<uint64_t> neighbours(n);
+    int distinct = countDistinct(colors);
+    for (int round = 0; round < n && distinct < n; ++round) {
+        for (int u = 0; u < n; ++u) {
+            neighbours.clear();
+            for (int v = 0; v < n; ++v) {
+                if (v != u) neighbours.push_back(mix(colors[v], together[u * n + v]));
+            }
+            std::sort(neighbours.begin(), neighbours.end());
+
+            uint64_t h = colors[u];
+            for (uint64_t x : neighbours) {
+                h = mix(h, x);
+            }
+            next[u] = h;
+        }
+        colors.swap(next);
+
+        int refined = countDistinct(colors);
+        if (refined == distinct) break;
+        distinct = refined;
+    }
+
+    std::sort(colors.begin(), colors.end());
+    uint64_t certificate = mix(n, count);
+    for (uint64_t c : colors) {
+        certificate = mix(certificate, c);
+    }
+    // 0 stands for "not computed"
+    return certificate != 0 ? certificate : 1;
+}
+
+void CertificateIndex::add(uint64_t certificate, int outSize, int index) {
+    Shard& shard = shards_[(certificate >> 58) % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entries[certificate].emplace_back(outSize, index);
+}
+
+std::vector<CertificateIndex::Entry> CertificateIndex::find(uint64_t certificate) const {
+    const Shard& shard = shards_[(certificate >> 58) % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(certificate);
+    return it != shard.entries.end() ? it->second : std::vector<Entry>();
+}
+
+void CertificateIndex::clear() {
+    for (Shard& shard : shards_) {
+        shard.entries.clear();
+    }
+}
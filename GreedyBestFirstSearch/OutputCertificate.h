@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class OutputSet;
+
+// Certificate of an output set up to a permutation of the wires.
+//
+// The wires are colored by color refinement, as in graph canonization: a
+// wire starts with the number of values having a 1 on it in each cluster,
+// then is repeatedly recolored by its color and the multiset of (color,
+// co-occurrence count) over the other wires, until the partition of the
+// wires stops splitting. The certificate hashes the size of the set with the
+// sorted final colors.
+//
+// Output sets equal up to a permutation have the same certificate; the
+// converse does not hold (refinement can stall on symmetric sets, and the
+// result is a hash), so a match must be confirmed by a subsumption test.
+class OutputCertificate {
+public:
+    static uint64_t of(const OutputSet& outputSet);
+};
+
+// Networks of a level indexed by certificate, as (output size, index) pairs
+// into the WorkingList; lookups resolve them under an epoch guard and skip
+// the ones removed since. Sharded like OutputHashSet.
+class CertificateIndex {
+public:
+    using Entry = std::pair<int, int>;
+
+    void add(uint64_t certificate, int outSize, int index);
+    // The networks registered with this certificate, at the time of the call.
+    std::vector<Entry> find(uint64_t certificate) const;
+    // No other thread may use the index meanwhile.
+    void clear();
+
+private:
+    static constexpr int SHARDS = 64;
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, std::vector<Entry>> entries;
+    };
+
+    Shard shards_[SHARDS];
+};
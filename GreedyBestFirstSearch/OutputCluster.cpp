@@ -2,22 +2,17 @@
 #include "OutputSet.h"
 #include "Network.h"
 #include "Tools.h"
+#include "BitOps.h"
 
 #include <stdexcept>
 #include <sstream>
 #include <bitset>
 #include <cstring>
 
-OutputCluster::OutputCluster(OutputSet* outputSet, int level)
-    : outputSet_(outputSet), level_(level), bitValues_(new ValuesBitSet()), size_(0),
-    count0_(0), count1_(0), pos0_(nbWires_, false), pos1_(nbWires_, false){
-    nbWires_ = outputSet->getNetwork()->nbWires();
-    pos0_.resize(nbWires_, false);
-    pos1_.resize(nbWires_, false);
-}
-
-OutputCluster::~OutputCluster() {
-    delete bitValues_;
+OutputCluster::OutputCluster(OutputSet* outputSet, int level, uint64_t* words)
+    : outputSet_(outputSet), level_(level), nbWires_(outputSet->getNbWires()), size_(0),
+    bitValues_(size_t(1) << nbWires_, words),
+    count0_(0), count1_(0), pos0_(0), pos1_(0) {
 }
 
 
@@ -36,23 +31,16 @@ int OutputCluster::add(const Sequence& sequence) {
     }
 
     int value = sequence.getValue();
-    if (bitValues_->get(value)) {
+    if (bitValues_.get(value)) {
         return -1;
     }
 
-    bitValues_->set(value);
-    const std::vector<bool>& bits = sequence.getBitSet();
+    bitValues_.set(value);
 
-    for (int i = 0; i < nbWires_; ++i) {
-        if (!pos0_[i] && !bits[i]) {
-            pos0_[i] = true;
-            count0_++;
-        }
-        if (!pos1_[i] && bits[i]) {
-            pos1_[i] = true;
-            count1_++;
-        }
-    }
+    pos0_ |= ~value & ((1 << nbWires_) - 1);
+    pos1_ |= value;
+    count0_ = BitOps::popcount(pos0_);
+    count1_ = BitOps::popcount(pos1_);
 
     size_++;
     return value;
@@ -64,25 +52,17 @@ int OutputCluster::size() const {
 }
 
 ValuesBitSet* OutputCluster::bitValues() {
-    return bitValues_;
+    return &bitValues_;
 }
 
 std::vector<int> OutputCluster::intValues() {
     if (!intValues_.empty()) return intValues_;
-    for (int i = bitValues_->nextSetBit(0); i >= 0; i = bitValues_->nextSetBit(i + 1)) {
+    for (int i = bitValues_.nextSetBit(0); i >= 0; i = bitValues_.nextSetBit(i + 1)) {
         intValues_.push_back(i);
     }
     return intValues_;
 }
 
-std::vector<bool>& OutputCluster::zeroPositions() {
-    return pos0_;
-}
-
-std::vector<bool>& OutputCluster::onePositions() {
-    return pos1_;
-}
-
 int OutputCluster::zeroCount() const {
     return count0_;
 }
@@ -93,13 +73,7 @@ int OutputCluster::oneCount() const {
 
 bool OutputCluster::includes(const OutputCluster& other) const {
     if (other.size_ > this->size_) return false;
-    ValuesBitSet* v0 = this->bitValues_;
-    ValuesBitSet* v1 = other.bitValues_;
-
-    ValuesBitSet temp(v1->size());
-    temp.or_(*v1);
-    temp.andNot(*v0);
-    return temp.isEmpty();
+    return other.bitValues_.isSubsetOf(this->bitValues_);
 }
 
 bool OutputCluster::cannotSubsume(const OutputCluster& other) const {
@@ -107,13 +81,13 @@ bool OutputCluster::cannotSubsume(const OutputCluster& other) const {
 }
 
 bool OutputCluster::operator==(const OutputCluster& other) const {
-    return level_ == other.level_ && *bitValues_ == *(other.bitValues_);
+    return level_ == other.level_ && bitValues_ == other.bitValues_;
 }
 
 std::string OutputCluster::toString() const {
     std::ostringstream oss;
     oss << "{";
-    for (int i = bitValues_->nextSetBit(0); i >= 0; i = bitValues_->nextSetBit(i + 1)) {
+    for (int i = bitValues_.nextSetBit(0); i >= 0; i = bitValues_.nextSetBit(i + 1)) {
         oss << Tools::toBinaryString(i, nbWires_) << ",";
     }
     oss << "}";
@@ -123,7 +97,7 @@ std::string OutputCluster::toString() const {
 std::string OutputCluster::toStringZeros() const {
     std::string s;
     for (int i = 0; i < nbWires_; ++i) {
-        s += pos0_[i] ? "0" : "_";
+        s += (pos0_ >> (nbWires_ - 1 - i)) & 1 ? "0" : "_";
     }
     return s;
 }
@@ -131,11 +105,11 @@ std::string OutputCluster::toStringZeros() const {
 std::string OutputCluster::toStringOnes() const {
     std::string s;
     for (int i = 0; i < nbWires_; ++i) {
-        s += pos1_[i] ? "1" : "_";
+        s += (pos1_ >> (nbWires_ - 1 - i)) & 1 ? "1" : "_";
     }
     return s;
 }
 
 const ValuesBitSet* OutputCluster::bitValues() const {
-    return bitValues_;
+    return &bitValues_;
 }
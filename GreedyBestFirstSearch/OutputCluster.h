@@ -10,8 +10,8 @@ class Network;
 
 class OutputCluster {
 public:
-    OutputCluster(OutputSet* outputSet, int level);
-    ~OutputCluster();
+    // The values are stored in the words lent by the output set.
+    OutputCluster(OutputSet* outputSet, int level, uint64_t* words);
 
     OutputSet* getOutputSet() const;
     Network* getNetwork() const;
@@ -26,8 +26,10 @@ public:
 
     std::vector<int> intValues();
 
-    std::vector<bool>& zeroPositions();
-    std::vector<bool>& onePositions();
+    // Wires that carry a 0 (resp. 1) in at least one value of the cluster,
+    // laid out like the values themselves: wire i is bit nbWires - 1 - i.
+    int zeroPositions() const { return pos0_; }
+    int onePositions() const { return pos1_; }
 
     int zeroCount() const;
     int oneCount() const;
@@ -41,9 +43,6 @@ public:
     std::string toStringZeros() const;
     std::string toStringOnes() const;
 
-    const std::vector<bool>& getPos0() const { return pos0_; }
-    const std::vector<bool>& getPos1() const { return pos1_; }
-
 
 private:
     OutputSet* outputSet_;
@@ -51,11 +50,11 @@ private:
     int nbWires_;
     int size_;
 
-    ValuesBitSet* bitValues_;
+    ValuesBitSet bitValues_;
     mutable std::vector<int> intValues_;
     int count0_;
     int count1_;
-    std::vector<bool> pos0_;
-    std::vector<bool> pos1_;
+    int pos0_;
+    int pos1_;
 
 };
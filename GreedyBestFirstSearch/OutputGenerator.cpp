@@ -1,4 +1,5 @@
 #include "OutputGenerator.h"
+#include "BitOps.h"
 #include <cmath>
 #include <random>
 #include <stdexcept>
@@ -22,7 +23,7 @@ Sequence OutputGenerator::apply(const Sequence& input) const {
         bool bit0 = output.get(i);
         bool bit1 = output.get(j);
         if ((ascending && bit0 && !bit1) || (!ascending && !bit0 && bit1)) {
-            output = *Sequence::getSwappedInstance(&output, i, j);
+            output = output.swap(i, j);
         }
     }
 
@@ -30,7 +31,7 @@ Sequence OutputGenerator::apply(const Sequence& input) const {
 }
 
 Sequence OutputGenerator::apply(int input) const {
-    return apply(*Sequence::getInstance(nbWires_, input));
+    return apply(Sequence(nbWires_, input));
 }
 
 std::vector<int> OutputGenerator::apply(const std::vector<int>& input) const {
@@ -55,10 +56,113 @@ std::vector<int> OutputGenerator::apply(const std::vector<int>& input) const {
 
 OutputSet* OutputGenerator::createAll() const {
     auto* outputSet = new OutputSet(network_);
-    for (int value = 0; value < maxInputSize_; ++value) {
-        Sequence input = *Sequence::getInstance(nbWires_, value);
-        Sequence output = apply(input);
-        outputSet->add(output);
+    std::vector<uint64_t> wires(nbWires_ * BLOCK_WORDS);
+    std::vector<Comparator> comparators = network_->chain().toVector();
+
+    for (int base = 0; base < maxInputSize_; base += BLOCK_SIZE) {
+        loadInputs(base, wires.data());
+        applySliced(wires.data(), comparators);
+        scatter(wires.data(), std::min(BLOCK_SIZE, maxInputSize_ - base), outputSet);
     }
+    outputSet->computeMinMaxValues();
     return outputSet;
-}
\ No newline at end of file
+}
+
+// Output set obtained by running only the comparators fromComparator.. of the network
+// on the values of input, e.g. the output set of the parent network.
+OutputSet* OutputGenerator::createFrom(const OutputSet& input, int fromComparator) const {
+    auto* outputSet = new OutputSet(network_);
+    std::vector<uint64_t> wires(nbWires_ * BLOCK_WORDS);
+    std::vector<Comparator> comparators = network_->chain().toVector(fromComparator);
+    int values[BLOCK_SIZE];
+    int count = 0;
+
+    const ValuesBitSet* inputValues = input.bitValues();
+    for (int value = inputValues->nextSetBit(0); value >= 0; value = inputValues->nextSetBit(value + 1)) {
+        values[count++] = value;
+        if (count == BLOCK_SIZE) {
+            loadValues(values, count, wires.data());
+            applySliced(wires.data(), comparators);
+            scatter(wires.data(), count, outputSet);
+            count = 0;
+        }
+    }
+    if (count > 0) {
+        loadValues(values, count, wires.data());
+        applySliced(wires.data(), comparators);
+        scatter(wires.data(), count, outputSet);
+    }
+
+    outputSet->computeMinMaxValues();
+    return outputSet;
+}
+
+// Bit-slices the inputs base .. base + BLOCK_SIZE - 1: bit l of word w on wire i
+// is the value of wire i for input base + 64 * w + l (wire 0 is the most significant bit).
+void OutputGenerator::loadInputs(int base, uint64_t* wires) const {
+    static const uint64_t LOW_BITS[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+    };
+
+    for (int i = 0; i < nbWires_; ++i) {
+        int bit = nbWires_ - i - 1;
+        uint64_t* words = wires + i * BLOCK_WORDS;
+        for (int w = 0; w < BLOCK_WORDS; ++w) {
+            words[w] = bit < 6 ? LOW_BITS[bit] : (((base + 64 * w) >> bit) & 1 ? ~uint64_t(0) : 0);
+        }
+    }
+}
+
+// Bit-slices up to BLOCK_SIZE arbitrary values, lane l holding values[l].
+void OutputGenerator::loadValues(const int* values, int count, uint64_t* wires) const {
+    std::fill(wires, wires + nbWires_ * BLOCK_WORDS, 0);
+    for (int l = 0; l < count; ++l) {
+        uint64_t laneBit = uint64_t(1) << (l & 63);
+        int w = l >> 6;
+        uint64_t value = static_cast<uint64_t>(values[l]);
+        while (value != 0) {
+            int wire = nbWires_ - BitOps::ctz(value) - 1;
+            wires[wire * BLOCK_WORDS + w] |= laneBit;
+            value &= value - 1;
+        }
+    }
+}
+
+// A comparator moves the minimum to the lower wire: AND on the lower wire, OR on the upper one.
+void OutputGenerator::applySliced(uint64_t* wires, const std::vector<Comparator>& comparators) const {
+    for (const Comparator& c : comparators) {
+        int i = std::min(c.getWire0(), c.getWire1());
+        int j = std::max(c.getWire0(), c.getWire1());
+        uint64_t* lo = wires + i * BLOCK_WORDS;
+        uint64_t* hi = wires + j * BLOCK_WORDS;
+        for (int w = 0; w < BLOCK_WORDS; ++w) {
+            uint64_t a = lo[w];
+            uint64_t b = hi[w];
+            lo[w] = a & b;
+            hi[w] = a | b;
+        }
+    }
+}
+
+// Transposes the first count lanes back to output values and adds the new ones to the set.
+void OutputGenerator::scatter(const uint64_t* wires, int count, OutputSet* outputSet) const {
+    int values[64];
+    for (int w = 0; w * 64 < count; ++w) {
+        int lanes = std::min(64, count - w * 64);
+        std::fill(values, values + 64, 0);
+        for (int i = 0; i < nbWires_; ++i) {
+            int bit = 1 << (nbWires_ - i - 1);
+            uint64_t word = wires[i * BLOCK_WORDS + w];
+            while (word != 0) {
+                values[BitOps::ctz(word)] |= bit;
+                word &= word - 1;
+            }
+        }
+        for (int l = 0; l < lanes; ++l) {
+            if (!outputSet->contains(values[l])) {
+                outputSet->add(Sequence(nbWires_, values[l]));
+            }
+        }
+    }
+}
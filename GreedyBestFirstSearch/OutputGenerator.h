@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include <vector>
+#include <cstdint>
 #include "Network.h"
 #include "Sequence.h"
 #include "OutputSet.h"
@@ -18,8 +19,18 @@ public:
     std::vector<int> apply(const std::vector<int>& input) const;
 
     OutputSet* createAll() const;
+    OutputSet* createFrom(const OutputSet& input, int fromComparator) const;
+
+    // Inputs evaluated per comparator pass: one 64-bit word per lane group and wire.
+    static const int BLOCK_WORDS = 4;
+    static const int BLOCK_SIZE = 64 * BLOCK_WORDS;
 
 private:
+    void loadInputs(int base, uint64_t* wires) const;
+    void loadValues(const int* values, int count, uint64_t* wires) const;
+    void applySliced(uint64_t* wires, const std::vector<Comparator>& comparators) const;
+    void scatter(const uint64_t* wires, int count, OutputSet* outputSet) const;
+
     Network* network_;
     int nbWires_;
     int maxInputSize_;
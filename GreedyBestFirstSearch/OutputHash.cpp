@@ -0,0 +1,76 @@
+#include "OutputHash.h"
+#include "ValuesBitSet.h"
+
+namespace {
+    inline uint64_t rotl(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    // MurmurHash3 finalizer
+    inline uint64_t fmix64(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+}
+
+OutputHash OutputHash::of(const ValuesBitSet& values) {
+    // MurmurHash3 x64/128 mixing, one 64-bit word per lane and round
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    const uint64_t* words = values.words();
+    uint64_t h1 = values.nbWords();
+    uint64_t h2 = ~h1;
+    for (size_t i = 0; i < values.nbWords(); ++i) {
+        uint64_t k = words[i];
+        uint64_t k1 = rotl(k * c1, 31) * c2;
+        h1 = rotl(h1 ^ k1, 27) + h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        uint64_t k2 = rotl(k * c2, 33) * c1;
+        h2 = rotl(h2 ^ k2, 31) + h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+    return { h1, h2 };
+}
+
+bool OutputHashSet::insert(const OutputHash& hash) {
+    Shard& shard = shards_[hash.hi % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.hashes.insert(hash).second;
+}
+
+void OutputHashSet::clear() {
+    for (Shard& shard : shards_) {
+        shard.hashes.clear();
+    }
+}
+
+std::vector<OutputHash> OutputHashSet::values() const {
+    std::vector<OutputHash> all;
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        all.insert(all.end(), shard.hashes.begin(), shard.hashes.end());
+    }
+    return all;
+}
+
+size_t OutputHashSet::size() const {
+    size_t total = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.hashes.size();
+    }
+    return total;
+}
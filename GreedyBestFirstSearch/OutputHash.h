@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+class ValuesBitSet;
+
+// 128-bit hash of the packed values of an output set. Two networks with the
+// same hash are taken to have the same output set: at 128 bits a collision is
+// far less likely than any other failure of a run.
+struct OutputHash {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    static OutputHash of(const ValuesBitSet& values);
+
+    bool operator==(const OutputHash& other) const {
+        return lo == other.lo && hi == other.hi;
+    }
+
+    bool operator!=(const OutputHash& other) const {
+        return !(*this == other);
+    }
+
+    struct Hasher {
+        size_t operator()(const OutputHash& hash) const {
+            return static_cast<size_t>(hash.lo);
+        }
+    };
+};
+
+// Set of output hashes shared by the threads building a level. Split into
+// shards with a lock each, chosen by the hi word of the hash (the buckets of
+// a shard use lo), so concurrent inserts rarely wait on one another.
+class OutputHashSet {
+public:
+    // Adds the hash; false if it was already in the set.
+    bool insert(const OutputHash& hash);
+    // No other thread may use the set meanwhile.
+    void clear();
+    size_t size() const;
+    // The hashes of the set, in no particular order.
+    std::vector<OutputHash> values() const;
+
+private:
+    static constexpr int SHARDS = 64;
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_set<OutputHash, OutputHash::Hasher> hashes;
+    };
+
+    Shard shards_[SHARDS];
+};
@@ -2,16 +2,19 @@
 #include <sstream>
 #include <limits>
 #include <algorithm>
+#include <mutex>
+#include <new>
 
 OutputSet::OutputSet(Network* network)
-    : network_(network), nbWires_(network->nbWires()), values_(new ValuesBitSet()), size_(0),
+    : network_(network), nbWires_(network->nbWires()), block_(storage(nbWires_).allocate()),
+    clusters_(static_cast<OutputCluster*>(block_)), values_(size_t(1) << nbWires_, words(0)), size_(0),
     minClusterSize_(std::numeric_limits<int>::max()), maxClusterSize_(0),
     minZeroCount_(std::numeric_limits<int>::max()), maxZeroCount_(0),
     minOneCount_(std::numeric_limits<int>::max()), maxOneCount_(0) {
 
-    clusters_.resize(nbWires_ + 1);
+    std::fill(words(0), words(nbWires_ + 2), uint64_t(0));
     for (int level = 0; level <= nbWires_; ++level) {
-        clusters_[level] = new OutputCluster(this, level);
+        new (clusters_ + level) OutputCluster(this, level, words(level + 1));
     }
     /*
     * std::cout << "[DEBUG] OutputSet constructed at " << this
@@ -26,20 +29,36 @@ Network* OutputSet::getNetwork() const {
     return network_;
 }
 
-OutputCluster* OutputSet::cluster(int level) {
-    return clusters_[level];
+SlabPool& OutputSet::storage(int nbWires) {
+    static std::once_flag once[MAX_WIRES + 1];
+    static std::unique_ptr<SlabPool> pools[MAX_WIRES + 1];
+    if (nbWires < 0 || nbWires > MAX_WIRES) {
+        throw std::invalid_argument("Too many wires for an output set: " + std::to_string(nbWires));
+    }
+
+    std::call_once(once[nbWires], [nbWires]() {
+        size_t nbWords = ValuesBitSet::nbWords(size_t(1) << nbWires);
+        size_t blockSize = (nbWires + 1) * sizeof(OutputCluster) + (nbWires + 2) * nbWords * sizeof(uint64_t);
+        pools[nbWires] = std::make_unique<SlabPool>(blockSize, std::max<size_t>(1, SLAB_BYTES / blockSize));
+        });
+    return *pools[nbWires];
 }
 
-std::vector<OutputCluster*>& OutputSet::clusters() {
-    return clusters_;
+uint64_t* OutputSet::words(int i) const {
+    uint64_t* first = reinterpret_cast<uint64_t*>(clusters_ + nbWires_ + 1);
+    return first + i * ValuesBitSet::nbWords(size_t(1) << nbWires_);
+}
+
+OutputCluster* OutputSet::cluster(int level) {
+    return &clusters_[level];
 }
 
 void OutputSet::add(const Sequence& sequence) {
     int level = sequence.cardinality();
-    OutputCluster* cluster = clusters_[level];
+    OutputCluster* cluster = &clusters_[level];
     int value = cluster->add(sequence);
     if (value >= 0) {
-        values_->set(value);
+        values_.set(value);
         ++size_;
     }
 }
@@ -53,7 +72,7 @@ void OutputSet::computeMinMaxValues() {
     maxOneCount_ = 0;
 
     for (int k = 1; k < nbWires_; ++k) {
-        OutputCluster* c = clusters_[k];
+        OutputCluster* c = &clusters_[k];
         int sz = c->size();
         minClusterSize_ = std::min(minClusterSize_, sz);
         maxClusterSize_ = std::max(maxClusterSize_, sz);
@@ -66,22 +85,25 @@ void OutputSet::computeMinMaxValues() {
         minOneCount_ = std::min(minOneCount_, oc);
         maxOneCount_ = std::max(maxOneCount_, oc);
     }
+
+    signature_.compute(*this);
+    hash_ = OutputHash::of(values_);
 }
 
 ValuesBitSet* OutputSet::bitValues() const {
-    return values_.get();
+    return const_cast<ValuesBitSet*>(&values_);
 }
 
 std::vector<int> OutputSet::intValues() {
     if (!intValues_.empty()) return intValues_;
-    for (int i = values_->nextSetBit(0); i >= 0; i = values_->nextSetBit(i + 1)) {
+    for (int i = values_.nextSetBit(0); i >= 0; i = values_.nextSetBit(i + 1)) {
         intValues_.push_back(i);
     }
     return intValues_;
 }
 
 bool OutputSet::contains(int value) const {
-    return values_->get(value);
+    return values_.get(value);
 }
 
 int OutputSet::size() const {
@@ -90,14 +112,7 @@ int OutputSet::size() const {
 
 bool OutputSet::includes(const OutputSet& other) const {
     if (other.size_ > size_) return false;
-
-    ValuesBitSet* bs = other.bitValues();
-    for (int value = bs->nextSetBit(0); value >= 0; value = bs->nextSetBit(value + 1)) {
-        if (!values_->get(value)) {
-            return false;
-        }
-    }
-    return true;
+    return other.values_.isSubsetOf(values_);
 }
 
 bool OutputSet::cannotSubsume(const OutputSet& other) const {
@@ -122,8 +137,13 @@ bool OutputSet::cannotSubsume(const OutputSet& other) const {
         return true;
     }
 
+    if (!signature_.isEmpty()) {
+        return signature_.sizesExceed(other.signature_);
+    }
+
+    // no signature above OutputSignature::MAX_WIRES: compare the clusters one by one
     for (int k = 1; k < nbWires_; ++k) {
-        if (clusters_[k]->cannotSubsume(*other.clusters_[k])) {
+        if (clusters_[k].cannotSubsume(other.clusters_[k])) {
             return true;
         }
     }
@@ -141,12 +161,12 @@ void OutputSet::computePosCount() {
     posCount0_.assign(nbWires_, 0);
     posCount1_.assign(nbWires_, 0);
 
-    for (int i = values_->nextSetBit(0); i >= 0; i = values_->nextSetBit(i + 1)) {
-        Sequence* s = Sequence::getInstance(nbWires_, i);
-        int k = s->cardinality();
+    for (int i = values_.nextSetBit(0); i >= 0; i = values_.nextSetBit(i + 1)) {
+        Sequence s(nbWires_, i);
+        int k = s.cardinality();
         for (int j = 0; j < nbWires_; ++j) {
-            if (j < nbWires_ - k && s->get(j)) posCount1_[j]++;
-            if (j >= nbWires_ - k && !s->get(j)) posCount0_[j]++;
+            if (j < nbWires_ - k && s.get(j)) posCount1_[j]++;
+            if (j >= nbWires_ - k && !s.get(j)) posCount0_[j]++;
         }
     }
 }
@@ -162,15 +182,15 @@ std::vector<int> OutputSet::posCount1() {
 }
 
 bool OutputSet::operator==(const OutputSet& other) const {
-    return *values_ == *(other.values_);
+    return values_ == other.values_;
 }
 
 std::string OutputSet::toString() const {
     std::ostringstream oss;
     oss << "{";
-    for (size_t i = 0; i < clusters_.size(); ++i) {
+    for (int i = 0; i <= nbWires_; ++i) {
         if (i > 0) oss << ",";
-        oss << clusters_[i]->toString();
+        oss << clusters_[i].toString();
     }
     oss << "}";
     return oss.str();
@@ -179,9 +199,9 @@ std::string OutputSet::toString() const {
 std::string OutputSet::toStringZeros() const {
     std::ostringstream oss;
     oss << "{";
-    for (size_t i = 0; i < clusters_.size(); ++i) {
+    for (int i = 0; i <= nbWires_; ++i) {
         if (i > 0) oss << ",";
-        oss << clusters_[i]->toStringZeros();
+        oss << clusters_[i].toStringZeros();
     }
     oss << "}";
     return oss.str();
@@ -190,9 +210,9 @@ std::string OutputSet::toStringZeros() const {
 std::string OutputSet::toStringOnes() const {
     std::ostringstream oss;
     oss << "{";
-    for (size_t i = 0; i < clusters_.size(); ++i) {
+    for (int i = 0; i <= nbWires_; ++i) {
         if (i > 0) oss << ",";
-        oss << clusters_[i]->toStringOnes();
+        oss << clusters_[i].toStringOnes();
     }
     oss << "}";
     return oss.str();
@@ -202,7 +222,7 @@ std::string OutputSet::toStringIntValues() const {
     std::ostringstream oss;
     oss << "{";
     bool first = true;
-    for (int i = values_->nextSetBit(0); i >= 0; i = values_->nextSetBit(i + 1)) {
+    for (int i = values_.nextSetBit(0); i >= 0; i = values_.nextSetBit(i + 1)) {
         if (!first) oss << ",";
         oss << i;
         first = false;
@@ -212,11 +232,12 @@ std::string OutputSet::toStringIntValues() const {
 }
 
 const OutputCluster* OutputSet::cluster(int level) const {
-    return clusters_[level];
+    return &clusters_[level];
 }
 
 OutputSet::~OutputSet() {
-    for (auto* cluster : clusters_) {
-        delete cluster;
+    for (int level = 0; level <= nbWires_; ++level) {
+        clusters_[level].~OutputCluster();
     }
+    storage(nbWires_).deallocate(block_);
 }
@@ -7,19 +7,29 @@
 #include "OutputCluster.h"
 #include "Sequence.h"
 #include "ValuesBitSet.h"
+#include "OutputSignature.h"
+#include "OutputHash.h"
+#include "SlabPool.h"
 
+// The clusters of an output set and the words of all its bitsets are held in
+// a single block of the SlabPool of its number of wires, rather than in some
+// 2n separate heap allocations.
 class OutputSet {
 public:
+    // Largest number of wires of an output set.
+    static const int MAX_WIRES = 30;
+
     explicit OutputSet(Network* network);
     ~OutputSet();
 
+    OutputSet(const OutputSet&) = delete;
+    OutputSet& operator=(const OutputSet&) = delete;
+
     Network* getNetwork() const;
 
     OutputCluster* cluster(int level);
     const OutputCluster* cluster(int level) const;
 
-    std::vector<OutputCluster*>& clusters();
-
     void add(const Sequence& sequence);
     void computeMinMaxValues();
 
@@ -32,6 +42,9 @@ public:
     bool includes(const OutputSet& other) const;
     bool cannotSubsume(const OutputSet& other) const;
 
+    const OutputSignature& signature() const { return signature_; }
+    const OutputHash& hash() const { return hash_; }
+
     int minClusterSize() const;
     int maxClusterSize() const;
     int minZeroCount() const;
@@ -53,6 +66,12 @@ public:
     std::string toStringIntValues() const;
 
 private:
+    static const size_t SLAB_BYTES = 256 * 1024;
+
+    static SlabPool& storage(int nbWires);
+    // Words of the values (0) or of the cluster of a level (level + 1).
+    uint64_t* words(int i) const;
+
     void computePosCount();
     bool checkMatching(const OutputSet& other, const std::vector<int>& perm);
     std::vector<std::vector<int>> findMatching(const std::vector<std::vector<int>>& graph);
@@ -74,13 +93,14 @@ private:
         int u, int pos, std::vector<std::vector<int>>& visited);
 
     Network* network_;
-    std::vector<OutputCluster*> clusters_;
-    std::unique_ptr<ValuesBitSet> values_;
+    int nbWires_;
+    void* block_;                 // the clusters, then the words
+    OutputCluster* clusters_;
+    ValuesBitSet values_;
     std::vector<int> intValues_;
     std::vector<int> posCount0_;
     std::vector<int> posCount1_;
 
-    int nbWires_;
     int size_;
 
     int minClusterSize_;
@@ -89,4 +109,7 @@ private:
     int maxZeroCount_;
     int minOneCount_;
     int maxOneCount_;
+
+    OutputSignature signature_;
+    OutputHash hash_;
 };
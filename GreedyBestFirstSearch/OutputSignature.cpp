@@ -0,0 +1,93 @@
+#include "OutputSignature.h"
+#include "OutputSet.h"
+#include "OutputCluster.h"
+#include "BitOps.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+    constexpr uint64_t LANE_HIGH_BITS = 0x8000800080008000ULL;
+
+    // Values whose bit b is set, for the bits addressed inside a single word.
+    constexpr uint64_t IN_WORD_BITS[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+    };
+
+    void pack(const std::vector<uint16_t>& lanes, std::vector<uint64_t>& words) {
+        for (size_t i = 0; i < lanes.size(); i += 4) {
+            uint64_t word = 0;
+            for (size_t j = 0; j < 4 && i + j < lanes.size(); ++j) {
+                word |= uint64_t(lanes[i + j]) << (16 * j);
+            }
+            words.push_back(word);
+        }
+    }
+}
+
+OutputSignature::OutputSignature() : profilesOffset_(0) {}
+
+void OutputSignature::compute(const OutputSet& outputSet) {
+    words_.clear();
+    profilesOffset_ = 0;
+    int n = outputSet.getNbWires();
+    if (n > MAX_WIRES) return;
+
+    std::vector<uint16_t> sizes;
+    std::vector<uint16_t> profiles;
+    std::vector<int> ones(n);
+
+    for (int k = 1; k < n; ++k) {
+        const OutputCluster* cluster = outputSet.cluster(k);
+        int size = cluster->size();
+        sizes.push_back(uint16_t(size));
+
+        // ones[b]: number of values of the cluster with bit b set
+        std::fill(ones.begin(), ones.end(), 0);
+        const uint64_t* words = cluster->bitValues()->words();
+        for (size_t i = 0; i < cluster->bitValues()->nbWords(); ++i) {
+            uint64_t word = words[i];
+            if (word == 0) continue;
+            int count = BitOps::popcount(word);
+            for (int b = 0; b < n; ++b) {
+                if (b < 6) ones[b] += BitOps::popcount(word & IN_WORD_BITS[b]);
+                else if ((i >> (b - 6)) & 1) ones[b] += count;
+            }
+        }
+
+        std::sort(ones.begin(), ones.end(), std::greater<int>());
+        for (int b = 0; b < n; ++b) {
+            profiles.push_back(uint16_t(ones[b]));
+        }
+        // sorting the zero counts decreasingly is sorting the one counts increasingly
+        for (int b = n - 1; b >= 0; --b) {
+            profiles.push_back(uint16_t(size - ones[b]));
+        }
+    }
+
+    pack(sizes, words_);
+    profilesOffset_ = static_cast<int>(words_.size());
+    pack(profiles, words_);
+}
+
+bool OutputSignature::lanesExceed(const uint64_t* words0, const uint64_t* words1, int count) {
+    // lanes hold at most 15 bits, so (b | 2^15) - a keeps its high bit iff a <= b
+    for (int i = 0; i < count; ++i) {
+        if ((((words1[i] | LANE_HIGH_BITS) - words0[i]) & LANE_HIGH_BITS) != LANE_HIGH_BITS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OutputSignature::sizesExceed(const OutputSignature& other) const {
+    if (isEmpty() || other.isEmpty()) return false;
+    return lanesExceed(words_.data(), other.words_.data(), profilesOffset_);
+}
+
+bool OutputSignature::profilesExceed(const OutputSignature& other) const {
+    if (isEmpty() || other.isEmpty()) return false;
+    return lanesExceed(words_.data() + profilesOffset_, other.words_.data() + profilesOffset_,
+        static_cast<int>(words_.size()) - profilesOffset_);
+}
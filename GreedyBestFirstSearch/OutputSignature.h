@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+class OutputSet;
+
+// Permutation-invariant fingerprint of an output set, used to reject
+// subsumption candidates before any graph is built.
+//
+// Every quantity is stored in a 16-bit lane, four lanes per word:
+//  - sizes:    the size of each cluster 1..n-1;
+//  - profiles: for each cluster 1..n-1, the number of values having a 1 on
+//              each wire, then the number having a 0, both sorted in
+//              decreasing order.
+// If out0 subsumes out1 through some permutation, every lane of out0 is
+// less than or equal to the matching lane of out1, so one SWAR comparison
+// per word decides a whole block of conditions.
+// Signatures are left empty above MAX_WIRES (lanes would overflow); an empty
+// signature never rejects anything.
+class OutputSignature {
+public:
+    static constexpr int MAX_WIRES = 17;
+
+    OutputSignature();
+
+    void compute(const OutputSet& outputSet);
+
+    bool isEmpty() const { return words_.empty(); }
+
+    // The cluster sizes of this set exceed those of other.
+    bool sizesExceed(const OutputSignature& other) const;
+    // The sorted per-wire zero/one occurrence counts of this set exceed those of other.
+    bool profilesExceed(const OutputSignature& other) const;
+
+    // The cluster-size lanes alone, for the columns of a NetworkList.
+    static int nbSizeWords(int nbWires) { return nbWires > MAX_WIRES ? 0 : (nbWires + 2) / 4; }
+    const uint64_t* sizeWords() const { return words_.data(); }
+    int nbSizeWords() const { return profilesOffset_; }
+    static bool sizesExceed(const uint64_t* sizes0, const uint64_t* sizes1, int nbWords) {
+        return lanesExceed(sizes0, sizes1, nbWords);
+    }
+
+private:
+    static bool lanesExceed(const uint64_t* words0, const uint64_t* words1, int count);
+
+    std::vector<uint64_t> words_;
+    int profilesOffset_;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Comparator.h"
+#include <cstdint>
+
+// Comparator of a network of at most 16 wires in one byte: wire0 in the high
+// nibble, wire1 in the low one. 0 encodes no comparator, since wire0 != wire1.
+struct PackedComparator {
+    static constexpr int MAX_WIRES = 16;
+
+    uint8_t bits = 0;
+
+    PackedComparator() = default;
+    explicit PackedComparator(uint8_t bits) : bits(bits) {}
+    PackedComparator(int wire0, int wire1) : bits(static_cast<uint8_t>((wire0 << 4) | wire1)) {}
+
+    static bool fits(int nbWires) { return nbWires <= MAX_WIRES; }
+
+    int wire0() const { return bits >> 4; }
+    int wire1() const { return bits & 15; }
+    Comparator toComparator() const { return Comparator(wire0(), wire1()); }
+};
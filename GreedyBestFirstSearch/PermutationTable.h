@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+// Wire permutation applied to output values through one 16-entry table per nibble:
+// apply(v) is the value whose wire perm[i] holds the bit of wire i in v (see Sequence::permute).
+// Building it costs about 15 ORs per nibble, so it pays off after a handful of values.
+class PermutationTable {
+public:
+    static constexpr int MAX_NIBBLES = 8;
+
+    void build(const std::vector<int>& perm) {
+        int n = static_cast<int>(perm.size());
+        nibbles_ = (n + 3) / 4;
+        for (int k = 0; k < nibbles_; ++k) {
+            int* table = tables_[k];
+            table[0] = 0;
+            for (int j = 1; j < 16; ++j) {
+                int low = j & -j;
+                int b = 4 * k + (low == 1 ? 0 : low == 2 ? 1 : low == 4 ? 2 : 3);
+                int image = b < n ? 1 << (n - 1 - perm[n - 1 - b]) : 0;
+                table[j] = table[j & (j - 1)] | image;
+            }
+        }
+    }
+
+    int apply(int value) const {
+        int result = 0;
+        for (int k = 0; k < nibbles_; ++k) {
+            result |= tables_[k][(value >> (4 * k)) & 15];
+        }
+        return result;
+    }
+
+private:
+    int nibbles_ = 0;
+    int tables_[MAX_NIBBLES][16];
+};
@@ -21,9 +21,13 @@ RuntimeNetwork::RuntimeNetwork(Network* net)
 RuntimeNetwork::RuntimeNetwork(Network* net, int i, int j)
     : Network(net, i, j) {
     outSize = outputSet()->size();
-    outputSet()->computeMinMaxValues();
 }
 
+RuntimeNetwork::RuntimeNetwork(const RuntimeNetwork& other)
+    : Network(other), id(other.id),
+    checkedSubsumedById(other.checkedSubsumedById), checkedSubsumesId(other.checkedSubsumesId),
+    dead(other.dead.load()), outSize(other.outSize), certificate(other.certificate) {}
+
 int RuntimeNetwork::getId() const {
     return id;
 }
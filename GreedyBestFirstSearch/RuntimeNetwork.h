@@ -2,6 +2,7 @@
 
 #include "Network.h"
 #include <atomic>
+#include <cstdint>
 #include <mutex>
 
 class RuntimeNetwork : public Network {
@@ -13,12 +14,15 @@ public:
     int id = -1;
     int checkedSubsumedById = -1;
     int checkedSubsumesId = -1;
-    bool dead = false;
+    std::atomic<bool> dead{ false };
     int outSize = 0;
+    int index = -1;  // position in the NetworkList of its output size
+    uint64_t certificate = 0;  // OutputCertificate of its output set, 0 if not computed
 
     explicit RuntimeNetwork(int nbWires);
     explicit RuntimeNetwork(Network* net);
     RuntimeNetwork(Network* net, int i, int j);
+    RuntimeNetwork(const RuntimeNetwork& other);
     int getId() const;
     bool isDead() const;
     void createId();
@@ -0,0 +1,122 @@
+#include "Scheduler.h"
+#include "FastThreadPool.h"
+#include "ThreadPool.h"
+#include "ExecutorService.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+std::map<std::string, Scheduler::Factory>& Scheduler::registry() {
+    static std::map<std::string, Factory> factory = {
+        {"FastThreadPool", [](int nbThreads) { return new FastThreadPool(nbThreads); }},
+        {"ThreadPool", [](int nbThreads) { return new ThreadPool(nbThreads); }},
+        {"ExecutorService", [](int nbThreads) { return new ExecutorService(nbThreads); }},
+    };
+    return factory;
+}
+
+Scheduler* Scheduler::create(const std::string& name, int nbThreads) {
+    auto it = registry().find(name);
+    return it != registry().end() ? it->second(nbThreads) : nullptr;
+}
+
+void Scheduler::add(const std::string& name, Factory factory) {
+    registry()[name] = factory;
+}
+
+std::vector<std::string> Scheduler::names() {
+    std::vector<std::string> list;
+    for (const auto& entry : registry()) {
+        list.push_back(entry.first);
+    }
+    return list;
+}
+
+Scheduler::Scheduler(int nbThreads)
+    : nbThreads_(nbThreads), counters_(new Counters[nbThreads]), statsSince_(now()) {}
+
+Scheduler::~Scheduler() {}
+
+int64_t Scheduler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int Scheduler::nbThreads() const {
+    return nbThreads_;
+}
+
+void Scheduler::setTracing(bool tracing) {
+    tracing_ = tracing;
+}
+
+void Scheduler::wait() {
+    std::unique_lock<std::mutex> lock(waitMutex_);
+    cvDone_.wait(lock, [this]() { return tasksInFlight_ == 0; });
+}
+
+void Scheduler::execute(int id, Job& job) {
+    try {
+        job.task.run();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception in scheduled task: " << e.what() << std::endl;
+    }
+
+    Counters& counters = counters_[id];
+    counters.tasks.fetch_add(1, std::memory_order_relaxed);
+    if (job.submitted != 0) {
+        counters.latencies.push_back(now() - job.submitted);
+    }
+
+    if (--tasksInFlight_ == 0) {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        cvDone_.notify_all();
+    }
+}
+
+void Scheduler::countSteal(int id) {
+    counters_[id].steals.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Scheduler::parked(int id) {
+    counters_[id].parkedSince.store(now(), std::memory_order_relaxed);
+}
+
+void Scheduler::unparked(int id) {
+    Counters& counters = counters_[id];
+    int64_t since = std::max(counters.parkedSince.exchange(0, std::memory_order_relaxed), statsSince_.load());
+    counters.idle.fetch_add(std::max<int64_t>(now() - since, 0), std::memory_order_relaxed);
+}
+
+Scheduler::Stats Scheduler::stats() const {
+    Stats stats;
+    int64_t idle = 0;
+    int64_t time = now();
+    for (int i = 0; i < nbThreads_; ++i) {
+        const Counters& counters = counters_[i];
+        stats.tasks += counters.tasks.load();
+        stats.steals += counters.steals.load();
+        idle += counters.idle.load();
+
+        // still parked: count the time up to now
+        int64_t since = counters.parkedSince.load();
+        if (since != 0) {
+            idle += time - std::max(since, statsSince_.load());
+        }
+        stats.latencies.insert(stats.latencies.end(), counters.latencies.begin(), counters.latencies.end());
+    }
+    stats.idleMillis = idle / 1e6;
+    return stats;
+}
+
+void Scheduler::resetStats() {
+    statsSince_ = now();
+    for (int i = 0; i < nbThreads_; ++i) {
+        Counters& counters = counters_[i];
+        counters.tasks = 0;
+        counters.steals = 0;
+        counters.idle = 0;
+        counters.latencies.clear();
+    }
+}
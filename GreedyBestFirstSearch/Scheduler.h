@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Task.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Common interface of the thread pools, selected by name through Config ("scheduler").
+//
+// The base class counts the tasks in flight for wait() and keeps per-worker
+// statistics; the implementations only differ in how they queue, steal and park.
+class Scheduler {
+public:
+    using Factory = std::function<Scheduler* (int nbThreads)>;
+
+    struct Stats {
+        long tasks = 0;
+        long steals = 0;
+        // Time the workers spent parked, summed over all of them.
+        double idleMillis = 0;
+        // Nanoseconds from submission to completion of each task, only filled while tracing.
+        std::vector<int64_t> latencies;
+    };
+
+    virtual ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    template<typename Func>
+    void submit(Func task);
+
+    // Blocks until every submitted task has run.
+    void wait();
+
+    int nbThreads() const;
+    void setTracing(bool tracing);
+
+    // Statistics since construction or the last resetStats(); both are meant
+    // to be called between wait() and the next submit().
+    Stats stats() const;
+    void resetStats();
+
+    // New instance of the named scheduler (owned by the caller), nullptr if unknown.
+    static Scheduler* create(const std::string& name, int nbThreads);
+    static void add(const std::string& name, Factory factory);
+    static std::vector<std::string> names();
+
+protected:
+    explicit Scheduler(int nbThreads);
+
+    // Publishes the job to the workers; called from any thread.
+    virtual void push(const Job& job) = 0;
+
+    // Runs the job on worker id and accounts for it.
+    void execute(int id, Job& job);
+    void countSteal(int id);
+    void parked(int id);
+    void unparked(int id);
+
+    static int64_t now();
+
+private:
+    struct alignas(64) Counters {
+        std::atomic<long> tasks{ 0 };
+        std::atomic<long> steals{ 0 };
+        std::atomic<int64_t> idle{ 0 };
+        std::atomic<int64_t> parkedSince{ 0 };
+        std::vector<int64_t> latencies;
+    };
+
+    static std::map<std::string, Factory>& registry();
+
+    const int nbThreads_;
+    std::unique_ptr<Counters[]> counters_;
+    std::atomic<bool> tracing_{ false };
+    std::atomic<int64_t> statsSince_;
+
+    std::atomic<int> tasksInFlight_{ 0 };
+    std::mutex waitMutex_;
+    std::condition_variable cvDone_;
+};
+
+template<typename Func>
+void Scheduler::submit(Func task) {
+    // counted before it is published, so that wait() cannot miss it
+    ++tasksInFlight_;
+    push(Job{ Task::make(std::move(task)), tracing_.load(std::memory_order_relaxed) ? now() : 0 });
+}
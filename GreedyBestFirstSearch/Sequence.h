@@ -2,35 +2,40 @@
 
 #include <vector>
 #include <string>
+#include "BitOps.h"
 
+// Binary sequence of nbits values held in a single integer; wire 0 is the most
+// significant bit. Sequences are plain values: no allocation and no shared cache.
 class Sequence {
 private:
     int nbits_;
     int value_;
-    int cardinality_;
-    std::vector<bool> bitSet_;
-
-    static std::vector<std::vector<Sequence*>> CACHE;
-
-    Sequence(int nbits);
-    Sequence(int nbits, int value);
-    void setValue(int value);
-    void computeValue();
 
 public:
-    Sequence(const Sequence& other);
-
-    static void initializeCache(int maxNbWires);
-    static Sequence* getInstance(int nbits, int value);
-    static Sequence* getSwappedInstance(const Sequence* other, int idx0, int idx1);
-
-    int length() const;
-    int getValue() const;
-    int cardinality() const;
-    bool get(int bitIndex) const;
-    std::vector<bool> getBitSet() const;
-    Sequence* permute(const std::vector<int>& perm) const;
-    bool isSorted() const;
+    constexpr Sequence(int nbits, int value) : nbits_(nbits), value_(value) {}
+
+    constexpr int length() const { return nbits_; }
+    constexpr int getValue() const { return value_; }
+    int cardinality() const { return BitOps::popcount(static_cast<unsigned int>(value_)); }
+
+    constexpr bool get(int bitIndex) const {
+        return (value_ >> (nbits_ - bitIndex - 1)) & 1;
+    }
+
+    constexpr Sequence swap(int idx0, int idx1) const {
+        int shift0 = nbits_ - idx0 - 1;
+        int shift1 = nbits_ - idx1 - 1;
+        int diff = ((value_ >> shift0) ^ (value_ >> shift1)) & 1;
+        return Sequence(nbits_, value_ ^ ((diff << shift0) | (diff << shift1)));
+    }
+
+    // Moves the bit of wire i to wire perm[i].
+    Sequence permute(const std::vector<int>& perm) const;
+
+    // Sorted sequences are 0..01..1, i.e. the cardinality lowest bits set.
+    bool isSorted() const {
+        return value_ == (1 << cardinality()) - 1;
+    }
 
     std::string toString(int nbits) const;
     std::string toString() const;
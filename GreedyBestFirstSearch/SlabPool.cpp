@@ -0,0 +1,67 @@
+#include "SlabPool.h"
+#include <atomic>
+
+namespace {
+    size_t alignBlock(size_t size) {
+        size_t align = alignof(std::max_align_t);
+        return (size + align - 1) / align * align;
+    }
+}
+
+SlabPool::SlabPool(size_t blockSize, size_t blocksPerSlab)
+    : blockSize_(alignBlock(blockSize < sizeof(Block) ? sizeof(Block) : blockSize)),
+    blocksPerSlab_(blocksPerSlab) {}
+
+SlabPool::~SlabPool() = default;
+
+SlabPool::Shard& SlabPool::shard() {
+    static std::atomic<int> nextShard{ 0 };
+    thread_local int index = nextShard++ % NB_SHARDS;
+    return shards_[index];
+}
+
+void* SlabPool::allocate() {
+    Shard& s = shard();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.free != nullptr) {
+            Block* block = s.free;
+            s.free = block->next;
+            return block;
+        }
+    }
+
+    // The first block of a new slab is returned, the others go to this shard.
+    Block* block = grow();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    char* bytes = reinterpret_cast<char*>(block);
+    for (size_t i = blocksPerSlab_ - 1; i > 0; --i) {
+        Block* next = reinterpret_cast<Block*>(bytes + i * blockSize_);
+        next->next = s.free;
+        s.free = next;
+    }
+    return block;
+}
+
+void SlabPool::deallocate(void* block) {
+    if (block == nullptr) return;
+    Shard& s = shard();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    Block* b = static_cast<Block*>(block);
+    b->next = s.free;
+    s.free = b;
+}
+
+SlabPool::Block* SlabPool::grow() {
+    size_t units = (blockSize_ * blocksPerSlab_ + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+    std::unique_ptr<std::max_align_t[]> slab(new std::max_align_t[units]);
+    Block* block = reinterpret_cast<Block*>(slab.get());
+    std::lock_guard<std::mutex> lock(slabsMutex_);
+    slabs_.push_back(std::move(slab));
+    return block;
+}
+
+size_t SlabPool::slabCount() const {
+    std::lock_guard<std::mutex> lock(slabsMutex_);
+    return slabs_.size();
+}
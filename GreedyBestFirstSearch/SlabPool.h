@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Allocator of fixed-size blocks, carved from slabs of many blocks at a time.
+//
+// Blocks are freed to a free list picked by the calling thread, one per
+// shard, so that the threads expanding and removing networks do not contend
+// on the heap or on a single lock. Slabs are only given back when the pool
+// is destroyed, all at once.
+class SlabPool {
+public:
+    SlabPool(size_t blockSize, size_t blocksPerSlab);
+    ~SlabPool();
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    void* allocate();
+    void deallocate(void* block);
+
+    size_t blockSize() const { return blockSize_; }
+    size_t slabCount() const;
+
+private:
+    struct Block {
+        Block* next;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        Block* free = nullptr;
+    };
+
+    static const int NB_SHARDS = 16;
+
+    Shard& shard();
+    Block* grow();
+
+    size_t blockSize_;
+    size_t blocksPerSlab_;
+    Shard shards_[NB_SHARDS];
+
+    mutable std::mutex slabsMutex_;
+    std::vector<std::unique_ptr<std::max_align_t[]>> slabs_;
+};
@@ -20,6 +20,8 @@ void Statistics::reset() {
     subPermutationFail = 0;
     redComparatorPos = 0;
     redSortedOutput = 0;
+    redDuplicateOutput = 0;
+    redPermutedOutput = 0;
     permTotal = 0;
     subsumedMap.clear();
     failMap.clear();
@@ -90,14 +92,18 @@ std::string Statistics::getExtendedInfo() {
         oss << "\t- detected: " << subDetected
             << " (" << (subTotal > 0 ? 100.0 * subDetected / subTotal : 0) << "%)\n";
         oss << "\t- due to direct output inclusion: " << subOutputInclusion << "\n";
-        oss << "\t- failed by cluster sizes: " << subClusterSizeFail << "\n";
-        oss << "\t- failed by different zero/one sizes: " << subZeroOneSizeFail << "\n";
+        oss << "\t- failed by cluster sizes: " << subClusterSizeFail
+            << " (" << (subTotal > 0 ? 100.0 * subClusterSizeFail / subTotal : 0) << "%)\n";
+        oss << "\t- failed by different zero/one sizes: " << subZeroOneSizeFail
+            << " (" << (subTotal > 0 ? 100.0 * subZeroOneSizeFail / subTotal : 0) << "%)\n";
         oss << "\t- no permutation: " << subPermutationFail << "\n";
         oss << "\t- zero/one permutation fails: " << subZeroOnePermFail << "\n";
         oss << "\t- values permutation fails: " << subValuesPermFail << "\n";
         oss << "Redundancies\n";
         oss << "\t- due to comparator positions: " << redComparatorPos << "\n";
         oss << "\t- due to sorted output: " << redSortedOutput << "\n";
+        oss << "\t- due to duplicate output set: " << redDuplicateOutput << "\n";
+        oss << "\t- due to permuted output set: " << redPermutedOutput << "\n";
     }
 
     return oss.str();
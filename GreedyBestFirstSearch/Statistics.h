@@ -30,6 +30,8 @@ public:
     static inline int subPermutationFail = 0;
     static inline int redComparatorPos = 0;
     static inline int redSortedOutput = 0;
+    static inline int redDuplicateOutput = 0;
+    static inline int redPermutedOutput = 0;
 
     static inline long long permTotal = 0;
 
@@ -1,7 +1,8 @@
 ﻿#include "Subsumption.h"
 #include "Permutations.h"
-#include "Sequence.h"
 #include "Statistics.h"
+#include "BitOps.h"
+#include <algorithm>
 
 std::vector<int> Subsumption::check(Network* net0, Network* net1) {
     if (Statistics::ENABLED) {
@@ -18,6 +19,13 @@ std::vector<int> Subsumption::check(Network* net0, Network* net1) {
         return {};
     }
 
+    if (out0->signature().profilesExceed(out1->signature())) {
+        if (Statistics::ENABLED) {
+            Statistics::subZeroOneSizeFail++;
+        }
+        return {};
+    }
+
     if (out1->includes(*out0)) {
         if (Statistics::ENABLED) {
             Statistics::subOutputInclusion++;
@@ -25,6 +33,7 @@ std::vector<int> Subsumption::check(Network* net0, Network* net1) {
         return Permutations::identity(net0->nbWires());
     }
 
+    clusterOrderValid_ = false;
     std::vector<int> perm = findPermutation(*out0, *out1);
     if (Statistics::ENABLED && !perm.empty()) {
         Statistics::subDetected++;
@@ -39,25 +48,87 @@ bool Subsumption::cannotSubsume(const OutputCluster& c0, const OutputCluster& c1
         c0.oneCount() > c1.oneCount();
 }
 
-bool Subsumption::checkPermutation(const OutputCluster& c0, const OutputCluster& c1, const std::vector<int>& perm) const {
-    const ValuesBitSet* values0 = c0.bitValues();
-    const ValuesBitSet* values1 = c1.bitValues();
-    int n = c0.getNetwork()->nbWires();
-
-    for (int value0 = values0->nextSetBit(0); value0 >= 0; value0 = values0->nextSetBit(value0 + 1)) {
-        int value1 = Sequence::getInstance(n, value0)->permute(perm)->getValue();
-        if (!values1->get(value1)) {
-            return false;
+void Subsumption::buildGraph(const OutputSet& out0, const OutputSet& out1, int fromLevel, int toLevel,
+    std::vector<int>& rows) const {
+    int n = out0.getNbWires();
+    int full = (1 << n) - 1;
+    rows.assign(n, full);
+
+    for (int k = fromLevel; k <= toLevel; ++k) {
+        const OutputCluster* c0 = out0.cluster(k);
+        const OutputCluster* c1 = out1.cluster(k);
+        if (!c0 || !c1) continue;
+
+        int zeros0 = c0->zeroPositions(), ones0 = c0->onePositions();
+        int zeros1 = c1->zeroPositions(), ones1 = c1->onePositions();
+        bool sameSize = c0->size() == c1->size();
+
+        // A 0 (resp. 1) on wire u must land on a wire that carries a 0 (resp. 1) in out1;
+        // with equal sizes the inclusion is an equality, so the converse holds as well.
+        for (int u = 0; u < n; ++u) {
+            int bit = 1 << (n - 1 - u);
+            int row = rows[u];
+            if (zeros0 & bit) row &= zeros1;
+            else if (sameSize) row &= ~zeros1;
+            if (ones0 & bit) row &= ones1;
+            else if (sameSize) row &= ~ones1;
+            rows[u] = row;
         }
     }
-    return true;
 }
 
-bool Subsumption::checkPermutation(const OutputSet& out0, const OutputSet& out1, const std::vector<int>& perm) const {
+void Subsumption::orderClusters(const OutputSet& out0, const OutputSet& out1) const {
+    // A cluster with little room left in out1 (and few values to map) fails fastest:
+    // order by the size difference, then by the size of the cluster of out0.
+    clusterOrder_.clear();
     for (int k = 2; k < out0.getNbWires() - 1; ++k) {
-        if (!checkPermutation(*out0.cluster(k), *out1.cluster(k), perm)) {
-            return false;
+        clusterOrder_.push_back(k);
+    }
+    auto key = [&](int k) {
+        int size0 = out0.cluster(k)->size();
+        return std::make_pair(out1.cluster(k)->size() - size0, size0);
+    };
+    for (size_t i = 1; i < clusterOrder_.size(); ++i) {
+        int k = clusterOrder_[i];
+        size_t j = i;
+        for (; j > 0 && key(k) < key(clusterOrder_[j - 1]); --j) {
+            clusterOrder_[j] = clusterOrder_[j - 1];
         }
+        clusterOrder_[j] = k;
+    }
+    clusterOrderValid_ = true;
+}
+
+bool Subsumption::includesPermuted(const OutputCluster& c0, const OutputCluster& c1) const {
+    const uint64_t* words0 = c0.bitValues()->words();
+    const uint64_t* words1 = c1.bitValues()->words();
+
+    for (size_t i = 0; i < c0.bitValues()->nbWords(); ++i) {
+        for (uint64_t word = words0[i]; word != 0; word &= word - 1) {
+            int value1 = permTable_.apply(static_cast<int>(i * 64) + BitOps::ctz(word));
+            if (!((words1[value1 >> 6] >> (value1 & 63)) & 1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool Subsumption::checkPermutation(const OutputCluster& c0, const OutputCluster& c1, const std::vector<int>& perm) const {
+    permTable_.build(perm);
+    return includesPermuted(c0, c1);
+}
+
+bool Subsumption::checkPermutation(const OutputSet& out0, const OutputSet& out1, const std::vector<int>& perm) const {
+    // findPermutation() called outside check() may find the order of another pair:
+    // harmless for the result as long as it lists the same clusters
+    if (!clusterOrderValid_ || clusterOrder_.size() != static_cast<size_t>(std::max(out0.getNbWires() - 3, 0))) {
+        orderClusters(out0, out1);
+    }
+    permTable_.build(perm);
+
+    for (int k : clusterOrder_) {
+        if (!includesPermuted(*out0.cluster(k), *out1.cluster(k))) return false;
     }
     return true;
 }
@@ -5,6 +5,7 @@
 #include "OutputSet.h"
 #include "OutputCluster.h"
 #include "ValuesBitSet.h"
+#include "PermutationTable.h"
 
 class Subsumption {
 public:
@@ -17,6 +18,21 @@ public:
 protected:
     bool cannotSubsume(const OutputCluster& c0, const OutputCluster& c1) const;
 
+    // rows[u] receives the wires of out1 that wire u of out0 may be mapped to,
+    // considering clusters fromLevel..toLevel (value layout: wire v is bit n - 1 - v).
+    void buildGraph(const OutputSet& out0, const OutputSet& out1, int fromLevel, int toLevel,
+        std::vector<int>& rows) const;
+
     bool checkPermutation(const OutputCluster& c0, const OutputCluster& c1, const std::vector<int>& perm) const;
     bool checkPermutation(const OutputSet& out0, const OutputSet& out1, const std::vector<int>& perm) const;
+
+private:
+    // Clusters 2..n-2, those most likely to reject a permutation first.
+    // Computed on the first permutation checked by each check() call.
+    void orderClusters(const OutputSet& out0, const OutputSet& out1) const;
+    bool includesPermuted(const OutputCluster& c0, const OutputCluster& c1) const;
+
+    mutable std::vector<int> clusterOrder_;
+    mutable bool clusterOrderValid_ = false;
+    mutable PermutationTable permTable_;
 };
@@ -2,19 +2,24 @@
 
 #include "Subsumption.h"
 #include <vector>
-#include <functional>
 
+// Exhaustive alternative to SubsumptionMatchImpl: checks that a perfect matching exists,
+// then tries the matchings in lexicographic order. The graph and the search buffers are
+// members reused from one check to the next; use one instance per thread
+// (SubsumptionVerifier::getInstance does).
 class SubsumptionBipartiteMatching : public Subsumption {
 public:
     std::vector<int> findPermutation(const OutputSet& out0, const OutputSet& out1) override;
 
 private:
-    int n;
-    std::vector<std::vector<bool>> graph;
+    int n = 0;
+    std::vector<int> graph;  // row masks, see Subsumption::buildGraph
+    std::vector<int> matchTo;
+    std::vector<int> match;
+    int visited = 0;
 
     void buildSubsumptionGraph(const OutputSet& out0, const OutputSet& out1);
-    bool findInitialMatching(std::vector<int>& matchTo);
-    void enumerateMatchings(std::vector<int>& matchTo, std::function<bool(const std::vector<int>&)> callback);
-    void dfsEnumerate(std::vector<int>& match, std::vector<bool>& used, int u,
-        std::function<bool(const std::vector<int>&)> callback);
+    bool findInitialMatching();
+    bool augment(int u);
+    bool dfsEnumerate(const OutputSet& out0, const OutputSet& out1, int used, int u);
 };
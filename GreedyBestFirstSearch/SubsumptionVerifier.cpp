@@ -1,28 +1,77 @@
 ﻿#include "SubsumptionVerifier.h"
 #include "Config.h"
+#include "Network.h"
 #include "SubsumptionMatchImpl.h"
+#include "SubsumptionBipartiteMatching.h"
 #include <iostream>
-#include <map>
-#include <functional>
+#include <fstream>
+#include <mutex>
+#include <memory>
+#include <typeinfo>
 
-Subsumption* SubsumptionVerifier::instance_ = nullptr;
+std::map<std::string, SubsumptionVerifier::Factory>& SubsumptionVerifier::registry() {
+    static std::map<std::string, Factory> factory = {
+        {"SubsumptionMatchImpl", []() { return new SubsumptionMatchImpl(); }},
+        {"SubsumptionBipartiteMatching", []() { return new SubsumptionBipartiteMatching(); }},
+    };
+    return factory;
+}
 
 Subsumption* SubsumptionVerifier::getInstance() {
-    if (instance_ == nullptr) {
-        std::string implName = Config::getSubsumptionImpl();
+    thread_local Subsumption* instance = getInstance(Config::getSubsumptionImpl());
+    if (!instance) {
+        std::cerr << "Unknown implementation: " << Config::getSubsumptionImpl() << "\n";
+    }
+    return instance;
+}
 
-        static const std::map<std::string, std::function<Subsumption* ()>> factory = {
-            {"SubsumptionMatchImpl", []() { return new SubsumptionMatchImpl(); }},
-        };
+Subsumption* SubsumptionVerifier::getInstance(const std::string& name) {
+    // one instance per thread: the implementations keep their search buffers in members
+    thread_local std::map<std::string, std::unique_ptr<Subsumption>> instances;
+    auto it = instances.find(name);
+    if (it == instances.end()) {
+        it = instances.emplace(name, std::unique_ptr<Subsumption>(create(name))).first;
+    }
+    return it->second.get();
+}
 
-        auto it = factory.find(implName);
-        if (it != factory.end()) {
-            instance_ = it->second();
-        }
-        else {
-            std::cerr << "Unknown implementation: " << implName << "\n";
-            instance_ = nullptr;
+std::string SubsumptionVerifier::nameOf(const Subsumption* verifier) {
+    if (!verifier) return "";
+    for (const auto& entry : registry()) {
+        std::unique_ptr<Subsumption> instance(entry.second());
+        if (instance && typeid(*instance) == typeid(*verifier)) {
+            return entry.first;
         }
     }
-    return instance_;
+    return "";
+}
+
+Subsumption* SubsumptionVerifier::create(const std::string& name) {
+    auto it = registry().find(name);
+    return it != registry().end() ? it->second() : nullptr;
+}
+
+void SubsumptionVerifier::add(const std::string& name, Factory factory) {
+    registry()[name] = factory;
+}
+
+std::vector<std::string> SubsumptionVerifier::names() {
+    std::vector<std::string> list;
+    for (const auto& entry : registry()) {
+        list.push_back(entry.first);
+    }
+    return list;
+}
+
+void SubsumptionVerifier::record(Network* net0, Network* net1, const std::vector<int>& perm) {
+    static const std::string path = Config::getSubsumptionLog();
+    if (path.empty()) return;
+
+    static std::mutex mutex;
+    static std::ofstream out(path);
+    std::string line = std::to_string(net0->nbWires()) + " " + (perm.empty() ? "0 " : "1 ")
+        + net0->toParseableString() + " " + net1->toParseableString() + "\n";
+
+    std::lock_guard<std::mutex> lock(mutex);
+    out << line;
 }
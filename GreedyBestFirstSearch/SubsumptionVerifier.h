@@ -1,11 +1,34 @@
 #pragma once
 
 #include "Subsumption.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <map>
 
+class Network;
+
+// Registry of the subsumption implementations, selected by name through Config ("subsumption").
 class SubsumptionVerifier {
 public:
+    using Factory = std::function<Subsumption* ()>;
+
+    // Instance of the configured implementation owned by the calling thread.
     static Subsumption* getInstance();
+    // Instance of the named implementation owned by the calling thread, nullptr if unknown.
+    static Subsumption* getInstance(const std::string& name);
+    // Name under which the implementation of verifier is registered, empty if none.
+    static std::string nameOf(const Subsumption* verifier);
+
+    // New instance of the named implementation (owned by the caller), nullptr if unknown.
+    static Subsumption* create(const std::string& name);
+    static void add(const std::string& name, Factory factory);
+    static std::vector<std::string> names();
+
+    // Appends the query to the file given by Config ("subsumptionLog"), if any,
+    // as "<nbWires> <found> <net0> <net1>" so it can be replayed by Benchmarks::subsumption.
+    static void record(Network* net0, Network* net1, const std::vector<int>& perm);
 
 private:
-    static Subsumption* instance_;
+    static std::map<std::string, Factory>& registry();
 };
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// A callable packed into a fixed number of machine words, so that it can be
+// copied word by word through the lock-free deques of the thread pool.
+//
+// Small trivially copyable callables (NetworkExpander, NetworkRemover) are
+// stored inline and cost no allocation; anything else is boxed on the heap and
+// deleted after it ran. A task must be run exactly once. Return values are
+// discarded.
+class Task {
+public:
+    using Word = uintptr_t;
+    static constexpr int WORDS = 4;
+    static constexpr int PAYLOAD_WORDS = WORDS - 1;
+
+    Task() = default;
+
+    template <typename Func>
+    static Task make(Func func) {
+        Task task;
+        std::memset(task.payload_, 0, sizeof(task.payload_));
+        if constexpr (std::is_trivially_copyable_v<Func>
+            && sizeof(Func) <= sizeof(payload_)
+            && alignof(Func) <= alignof(Word)) {
+            std::memcpy(task.payload_, &func, sizeof(Func));
+            task.invoke_ = &runInline<Func>;
+        }
+        else {
+            Func* boxed = new Func(std::move(func));
+            std::memcpy(task.payload_, &boxed, sizeof(boxed));
+            task.invoke_ = &runBoxed<Func>;
+        }
+        return task;
+    }
+
+    void run() {
+        invoke_(payload_);
+    }
+
+    explicit operator bool() const {
+        return invoke_ != nullptr;
+    }
+
+private:
+    using Invoke = void (*)(Word*);
+
+    template <typename Func>
+    static void runInline(Word* payload) {
+        (*std::launder(reinterpret_cast<Func*>(payload)))();
+    }
+
+    template <typename Func>
+    static void runBoxed(Word* payload) {
+        Func* boxed;
+        std::memcpy(&boxed, payload, sizeof(boxed));
+        std::unique_ptr<Func> owner(boxed);
+        (*owner)();
+    }
+
+    Invoke invoke_ = nullptr;
+    Word payload_[PAYLOAD_WORDS];
+};
+
+static_assert(std::is_trivially_copyable_v<Task>, "Task must be copyable word by word.");
+static_assert(sizeof(Task) == Task::WORDS * sizeof(Task::Word), "Task must fill exactly WORDS words.");
+
+// A task as queued by the schedulers, with the time it was submitted
+// (steady clock nanoseconds, 0 when latencies are not traced).
+struct Job {
+    Task task;
+    int64_t submitted;
+};
+
+static_assert(std::is_trivially_copyable_v<Job>, "Job must be copyable word by word.");
+static_assert(sizeof(Job) % sizeof(Task::Word) == 0, "Job must fill whole words.");
@@ -1,74 +1,78 @@
 ﻿#include "ThreadPool.h"
 
-ThreadPool::ThreadPool(size_t numThreads) : workers_(numThreads), taskCounters_(numThreads) {
-    for (auto& counter : taskCounters_) {
-        counter = 0;
-    }
-
-    for (size_t i = 0; i < numThreads; ++i) {
+ThreadPool::ThreadPool(int numThreads) : Scheduler(numThreads), workers_(numThreads) {
+    for (int i = 0; i < numThreads; ++i) {
         threads_.emplace_back([this, i]() { workerLoop(i); });
     }
 }
 
 ThreadPool::~ThreadPool() {
-    stop_ = true;
-
-    for (auto& worker : workers_) {
-        std::lock_guard<std::mutex> lock(worker.mutex);
-        worker.queue.emplace_back([] {});
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        stop_ = true;
     }
+    cvWork_.notify_all();
 
     for (auto& t : threads_) {
         if (t.joinable()) t.join();
     }
-
-    for (size_t i = 0; i < taskCounters_.size(); ++i) {
-        std::cout << "[Thread #" << i << "] tasks executed: " << taskCounters_[i] << "\n";
-    }
 }
 
-void ThreadPool::wait() {
-    std::unique_lock<std::mutex> lock(waitMutex_);
-    cvDone_.wait(lock, [this]() { return tasksInFlight_ == 0; });
+void ThreadPool::push(const Job& job) {
+    size_t i = index_.fetch_add(1) % workers_.size();
+    {
+        std::lock_guard<std::mutex> lock(workers_[i].mutex);
+        workers_[i].queue.push_back(job);
+        ++queued_;
+    }
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+    }
+    cvWork_.notify_one();
 }
 
-void ThreadPool::workerLoop(size_t id) {
+void ThreadPool::workerLoop(int id) {
     auto& self = workers_[id];
-    while (!stop_) {
-        std::function<void()> task;
+    int n = static_cast<int>(workers_.size());
+    while (true) {
+        Job job;
+        bool found = false;
 
         {
             std::lock_guard<std::mutex> lock(self.mutex);
             if (!self.queue.empty()) {
-                task = std::move(self.queue.front());
+                job = self.queue.front();
                 self.queue.pop_front();
+                --queued_;
+                found = true;
             }
         }
 
-        if (!task) {
-            for (size_t i = 0; i < workers_.size(); ++i) {
-                size_t victim = (id + i) % workers_.size();
-                if (victim == id) continue;
-
-                auto& other = workers_[victim];
+        if (!found) {
+            for (int i = 1; i < n && !found; ++i) {
+                auto& other = workers_[(id + i) % n];
                 std::lock_guard<std::mutex> lock(other.mutex);
                 if (!other.queue.empty()) {
-                    task = std::move(other.queue.back());
+                    job = other.queue.back();
                     other.queue.pop_back();
-                    break;
+                    --queued_;
+                    found = true;
+                    countSteal(id);
                 }
             }
         }
 
-        if (task) {
-            task();
-            taskCounters_[id]++;
-            if (--tasksInFlight_ == 0) {
-                cvDone_.notify_all();
-            }
+        if (found) {
+            execute(id, job);
         }
         else {
-            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            std::unique_lock<std::mutex> lock(parkMutex_);
+            if (stop_ && queued_ == 0) {
+                break;
+            }
+            parked(id);
+            cvWork_.wait(lock, [this]() { return stop_ || queued_ > 0; });
+            unparked(id);
         }
     }
 }
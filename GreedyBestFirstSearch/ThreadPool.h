@@ -1,57 +1,40 @@
 ﻿#pragma once
 
+#include "Scheduler.h"
 #include <vector>
 #include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <future>
-#include <functional>
 #include <atomic>
-#include <iostream>
 
-class ThreadPool {
+// Mutex-guarded queue per worker. Jobs are dealt round-robin; a worker runs
+// its own queue from the front and steals from the back of the others,
+// visiting them in order.
+class ThreadPool : public Scheduler {
 public:
-    explicit ThreadPool(size_t numThreads);
-    ~ThreadPool();
+    explicit ThreadPool(int numThreads);
+    ~ThreadPool() override;
 
-    template<typename Func>
-    auto submit(Func task) -> std::future<decltype(task())>;
-
-    void wait();
+protected:
+    void push(const Job& job) override;
 
 private:
-    void workerLoop(size_t id);
+    void workerLoop(int id);
 
     struct Worker {
         std::mutex mutex;
-        std::deque<std::function<void()>> queue;
+        std::deque<Job> queue;
     };
 
     std::vector<Worker> workers_;
     std::vector<std::thread> threads_;
-    std::vector<std::atomic<int>> taskCounters_;
 
     std::atomic<bool> stop_ = false;
     std::atomic<size_t> index_ = 0;
-    std::atomic<int> tasksInFlight_ = 0;
 
-    std::mutex waitMutex_;
-    std::condition_variable cvDone_;
+    // Jobs sitting in the queues; idle workers park until it is non-zero.
+    std::atomic<int> queued_ = 0;
+    std::mutex parkMutex_;
+    std::condition_variable cvWork_;
 };
-
-template<typename Func>
-auto ThreadPool::submit(Func task) -> std::future<decltype(task())> {
-    using ReturnType = decltype(task());
-    auto packagedTask = std::make_shared<std::packaged_task<ReturnType()>>(std::move(task));
-    std::future<ReturnType> result = packagedTask->get_future();
-
-    size_t i = index_.fetch_add(1) % workers_.size();
-    {
-        std::lock_guard<std::mutex> lock(workers_[i].mutex);
-        workers_[i].queue.emplace_back([packagedTask]() { (*packagedTask)(); });
-    }
-
-    ++tasksInFlight_;
-    return result;
-}
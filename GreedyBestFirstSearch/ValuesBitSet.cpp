@@ -1,87 +1,144 @@
 ﻿#include "ValuesBitSet.h"
+#include "BitOps.h"
 #include <stdexcept>
 #include <algorithm>
 
-ValuesBitSet::ValuesBitSet() = default;
+ValuesBitSet::ValuesBitSet() : size_(0), nbWords_(0), words_(nullptr) {}
 
-ValuesBitSet::ValuesBitSet(size_t size) : bits_(size, false) {}
+ValuesBitSet::ValuesBitSet(size_t size)
+    : size_(size), nbWords_(nbWords(size)), storage_(nbWords_, 0) {
+    words_ = storage_.data();
+}
 
-void ValuesBitSet::set(int index) {
-    if (index < 0) {
-        throw std::out_of_range("Index cannot be negative.");
+ValuesBitSet::ValuesBitSet(size_t size, uint64_t* storage)
+    : size_(size), nbWords_(nbWords(size)), words_(storage) {}
+
+ValuesBitSet::ValuesBitSet(const ValuesBitSet& other)
+    : size_(other.size_), nbWords_(other.nbWords_), storage_(other.words_, other.words_ + other.nbWords_) {
+    words_ = storage_.data();
+}
+
+ValuesBitSet& ValuesBitSet::operator=(const ValuesBitSet& other) {
+    if (this != &other) {
+        if (words_ != storage_.data() && nbWords_ == other.nbWords_) {
+            std::copy(other.words_, other.words_ + nbWords_, words_);
+        }
+        else {
+            storage_.assign(other.words_, other.words_ + other.nbWords_);
+            words_ = storage_.data();
+            nbWords_ = other.nbWords_;
+        }
+        size_ = other.size_;
     }
-    if (static_cast<size_t>(index) >= bits_.size()) {
-        bits_.resize(index + 1, false);
+    return *this;
+}
+
+void ValuesBitSet::set(int index) {
+    if (index < 0 || static_cast<size_t>(index) >= size_) {
+        throw std::out_of_range("Index outside of the bitset capacity.");
     }
-    bits_[index] = true;
+    words_[index >> 6] |= uint64_t(1) << (index & 63);
 }
 
 bool ValuesBitSet::get(int index) const {
-    if (index < 0 || static_cast<size_t>(index) >= bits_.size()) {
+    if (index < 0 || static_cast<size_t>(index) >= size_) {
         return false;
     }
-    return bits_[index];
+    return (words_[index >> 6] >> (index & 63)) & 1;
 }
 
 void ValuesBitSet::clear(int index) {
-    if (index < 0 || static_cast<size_t>(index) >= bits_.size()) {
+    if (index < 0 || static_cast<size_t>(index) >= size_) {
         return;
     }
-    bits_[index] = false;
+    words_[index >> 6] &= ~(uint64_t(1) << (index & 63));
 }
 
 void ValuesBitSet::clear() {
-    std::fill(bits_.begin(), bits_.end(), false);
+    std::fill(words_, words_ + nbWords_, 0);
 }
 
 int ValuesBitSet::nextSetBit(int fromIndex) const {
     if (fromIndex < 0) {
         throw std::out_of_range("fromIndex cannot be negative.");
     }
-    for (size_t i = fromIndex; i < bits_.size(); ++i) {
-        if (bits_[i]) {
-            return static_cast<int>(i);
+    if (static_cast<size_t>(fromIndex) >= size_) {
+        return -1;
+    }
+
+    size_t w = fromIndex >> 6;
+    uint64_t word = words_[w] & (~uint64_t(0) << (fromIndex & 63));
+    while (true) {
+        if (word != 0) {
+            return static_cast<int>(w * 64 + BitOps::ctz(word));
+        }
+        if (++w == nbWords_) {
+            return -1;
         }
+        word = words_[w];
     }
-    return -1;
 }
 
 int ValuesBitSet::cardinality() const {
-    return static_cast<int>(std::count(bits_.begin(), bits_.end(), true));
+    int count = 0;
+    for (size_t i = 0; i < nbWords_; ++i) {
+        count += BitOps::popcount(words_[i]);
+    }
+    return count;
 }
 
 size_t ValuesBitSet::size() const {
-    return bits_.size();
+    return size_;
 }
 
 bool ValuesBitSet::isEmpty() const {
-    return std::none_of(bits_.begin(), bits_.end(), [](bool b) { return b; });
+    for (size_t i = 0; i < nbWords_; ++i) {
+        if (words_[i] != 0) return false;
+    }
+    return true;
 }
 
 void ValuesBitSet::or_(const ValuesBitSet& other) {
-    size_t maxSize = std::max(bits_.size(), other.bits_.size());
-    bits_.resize(maxSize, false);
-    for (size_t i = 0; i < other.bits_.size(); ++i) {
-        bits_[i] = bits_[i] || other.bits_[i];
+    if (other.size_ > size_) {
+        if (words_ != storage_.data()) {
+            throw std::logic_error("Cannot grow a bitset over lent words.");
+        }
+        size_ = other.size_;
+        nbWords_ = other.nbWords_;
+        storage_.resize(nbWords_, 0);
+        words_ = storage_.data();
+    }
+    for (size_t i = 0; i < other.nbWords_; ++i) {
+        words_[i] |= other.words_[i];
     }
 }
 
 void ValuesBitSet::andNot(const ValuesBitSet& other) {
-    size_t minSize = std::min(bits_.size(), other.bits_.size());
-    for (size_t i = 0; i < minSize; ++i) {
-        if (other.bits_[i]) {
-            bits_[i] = false;
-        }
+    size_t n = std::min(nbWords_, other.nbWords_);
+    for (size_t i = 0; i < n; ++i) {
+        words_[i] &= ~other.words_[i];
     }
 }
 
-bool ValuesBitSet::operator==(const ValuesBitSet& other) const {
-    size_t maxSize = std::max(bits_.size(), other.bits_.size());
-    for (size_t i = 0; i < maxSize; ++i) {
-        bool b1 = i < bits_.size() ? bits_[i] : false;
-        bool b2 = i < other.bits_.size() ? other.bits_[i] : false;
-        if (b1 != b2) return false;
+bool ValuesBitSet::isSubsetOf(const ValuesBitSet& other) const {
+    size_t n = std::min(nbWords_, other.nbWords_);
+    for (size_t i = 0; i < n; ++i) {
+        if (words_[i] & ~other.words_[i]) return false;
+    }
+    for (size_t i = n; i < nbWords_; ++i) {
+        if (words_[i] != 0) return false;
     }
     return true;
 }
 
+bool ValuesBitSet::operator==(const ValuesBitSet& other) const {
+    const ValuesBitSet& small = nbWords_ <= other.nbWords_ ? *this : other;
+    const ValuesBitSet& large = nbWords_ <= other.nbWords_ ? other : *this;
+    for (size_t i = 0; i < small.nbWords_; ++i) {
+        if (small.words_[i] != large.words_[i]) return false;
+    }
+    for (size_t i = small.nbWords_; i < large.nbWords_; ++i) {
+        if (large.words_[i] != 0) return false;
+    }
+    return true;
+}
@@ -1,11 +1,23 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 
+// Fixed-capacity bitset over output values, stored as 64-bit words.
+// Owners size it to 2^n up front; indexes beyond the capacity are never set.
+// The words are either owned or lent by the owner (see OutputSet), in which
+// case they must outlive the bitset; a copy always owns its words.
 class ValuesBitSet {
 public:
     ValuesBitSet();
     explicit ValuesBitSet(size_t size);
+    // Over the nbWords(size) zeroed words at storage.
+    ValuesBitSet(size_t size, uint64_t* storage);
+    ValuesBitSet(const ValuesBitSet& other);
+    ValuesBitSet& operator=(const ValuesBitSet& other);
+
+    static size_t nbWords(size_t size) { return (size + 63) / 64; }
 
     void set(int index);
     bool get(int index) const;
@@ -19,9 +31,16 @@ public:
 
     void or_(const ValuesBitSet& other);
     void andNot(const ValuesBitSet& other);
+    bool isSubsetOf(const ValuesBitSet& other) const;
 
     bool operator==(const ValuesBitSet& other) const;
 
+    const uint64_t* words() const { return words_; }
+    size_t nbWords() const { return nbWords_; }
+
 private:
-    std::vector<bool> bits_;
+    size_t size_;
+    size_t nbWords_;
+    uint64_t* words_;
+    std::vector<uint64_t> storage_;
 };
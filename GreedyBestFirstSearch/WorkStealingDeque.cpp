@@ -0,0 +1,105 @@
+#include "WorkStealingDeque.h"
+
+#include <cstring>
+
+WorkStealingDeque::Buffer::Buffer(int64_t capacity)
+    : mask(capacity - 1), cells(new Cell[capacity]) {}
+
+void WorkStealingDeque::Buffer::put(int64_t i, const Job& job) {
+    Task::Word words[WORDS];
+    std::memcpy(words, &job, sizeof(words));
+    Cell& cell = cells[i & mask];
+    for (int w = 0; w < WORDS; ++w) {
+        cell.words[w].store(words[w], std::memory_order_relaxed);
+    }
+}
+
+Job WorkStealingDeque::Buffer::get(int64_t i) const {
+    Task::Word words[WORDS];
+    const Cell& cell = cells[i & mask];
+    for (int w = 0; w < WORDS; ++w) {
+        words[w] = cell.words[w].load(std::memory_order_relaxed);
+    }
+    Job job;
+    std::memcpy(&job, words, sizeof(words));
+    return job;
+}
+
+WorkStealingDeque::WorkStealingDeque(int capacity) {
+    // capacity must be a power of two
+    buffers_.push_back(std::make_unique<Buffer>(capacity));
+    buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+}
+
+WorkStealingDeque::~WorkStealingDeque() {}
+
+WorkStealingDeque::Buffer* WorkStealingDeque::grow(Buffer* buffer, int64_t top, int64_t bottom) {
+    buffers_.push_back(std::make_unique<Buffer>((buffer->mask + 1) * 2));
+    Buffer* bigger = buffers_.back().get();
+    for (int64_t i = top; i < bottom; ++i) {
+        bigger->put(i, buffer->get(i));
+    }
+    buffer_.store(bigger, std::memory_order_release);
+    return bigger;
+}
+
+void WorkStealingDeque::push(const Job& job) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+    if (b - t > buffer->mask) {
+        buffer = grow(buffer, t, b);
+    }
+    buffer->put(b, job);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+}
+
+bool WorkStealingDeque::pop(Job& job) {
+    int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        // empty
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    job = buffer->get(b);
+    if (t == b) {
+        // last task: race the thieves for it
+        bool won = top_.compare_exchange_strong(t, t + 1,
+            std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+bool WorkStealingDeque::steal(Job& job) {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+
+    if (t >= b) {
+        return false;
+    }
+
+    Buffer* buffer = buffer_.load(std::memory_order_acquire);
+    Job stolen = buffer->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1,
+        std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false;
+    }
+    job = stolen;
+    return true;
+}
+
+bool WorkStealingDeque::empty() const {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    return t >= b;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Task.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Chase-Lev work-stealing deque of jobs (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models", 2013).
+//
+// The owning thread pushes and pops at the bottom without locking; other
+// threads steal from the top with a single CAS. Jobs are stored as atomic
+// words, so a thief may read a cell while the owner writes another one; a
+// thief whose CAS fails discards what it read. Buffers only grow, and the old
+// ones are kept until the deque is destroyed because a thief may still be
+// reading from them.
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(int capacity = 256);
+    ~WorkStealingDeque();
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only.
+    void push(const Job& job);
+    // Owner only; takes the most recently pushed job.
+    bool pop(Job& job);
+    // Any thread; takes the oldest job. Also fails when losing a race.
+    bool steal(Job& job);
+
+    bool empty() const;
+
+private:
+    static constexpr int WORDS = sizeof(Job) / sizeof(Task::Word);
+
+    struct Cell {
+        std::atomic<Task::Word> words[WORDS];
+    };
+
+    struct Buffer {
+        int64_t mask;
+        std::unique_ptr<Cell[]> cells;
+
+        explicit Buffer(int64_t capacity);
+        void put(int64_t i, const Job& job);
+        Job get(int64_t i) const;
+    };
+
+    Buffer* grow(Buffer* buffer, int64_t top, int64_t bottom);
+
+    alignas(64) std::atomic<int64_t> top_{ 0 };
+    alignas(64) std::atomic<int64_t> bottom_{ 0 };
+    std::atomic<Buffer*> buffer_;
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+};
@@ -1,75 +1,103 @@
 ﻿#include "WorkingList.h"
 #include "NetworkGenerator.h"
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <sstream>
 
+namespace {
+    void storeMin(std::atomic<int>& target, int value) {
+        int current = target.load();
+        while (value < current && !target.compare_exchange_weak(current, value)) {}
+    }
+
+    void storeMax(std::atomic<int>& target, int value) {
+        int current = target.load();
+        while (value > current && !target.compare_exchange_weak(current, value)) {}
+    }
+}
+
 WorkingList::WorkingList(int nbWires, int maxOutSize)
     : nbWires_(nbWires) {
 
     array_.reserve(maxOutSize);
     for (int i = 0; i < maxOutSize; ++i) {
-        array_.emplace_back(std::make_unique<NetworkList>());
+        array_.emplace_back(std::make_unique<NetworkList>(OutputSignature::nbSizeWords(nbWires)));
     }
     std::cout << "WorkingList initialized, length=" << maxOutSize << std::endl;
 }
 
 int WorkingList::size() const {
-    std::lock_guard<std::recursive_mutex> lock(mtx_);
-    return size_;
+    return size_.load();
 }
 
 int WorkingList::aliveSize() const {
-    std::lock_guard<std::recursive_mutex> lock(mtx_);
-    return size_ - static_cast<int>(dead_.size());
+    return size_.load() - deadSize_.load();
 }
 
 void WorkingList::clear() {
-    std::lock_guard<std::recursive_mutex> lock(mtx_);
     for (auto& list : array_) {
         list->clear();
     }
+    epochs_.reclaimAll();
+    outputs_.clear();
+    certificates_.clear();
     size_ = 0;
+    deadSize_ = 0;
     maxId_ = -1;
     first_ = std::numeric_limits<int>::max();
     last_ = -1;
-    dead_.clear();
 }
 
 RuntimeNetwork* WorkingList::getNetwork(int outSize, int index) const {
-    std::lock_guard<std::recursive_mutex> lock(mtx_);
     return array_[outSize]->getNetwork(index);
 }
 
+bool WorkingList::claimOutput(const OutputHash& hash) {
+    return outputs_.insert(hash);
+}
+
+std::vector<OutputHash> WorkingList::claimedOutputs() const {
+    return outputs_.values();
+}
+
+bool WorkingList::findEquivalent(RuntimeNetwork* net) {
+    EpochManager::Guard guard(epochs_);
+
+    for (const auto& entry : certificates_.find(net->certificate)) {
+        if (entry.first != net->outSize) continue;
+
+        RuntimeNetwork* other = getNetwork(entry.first, entry.second);
+        // same size, so subsumption is a permutation mapping one set onto the other
+        if (other != nullptr && !other->isDead() && other->subsumes(net)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 NetworkList* WorkingList::networkList(int outSize) const {
     return array_[outSize].get();
 }
 
 void WorkingList::addDead(RuntimeNetwork* net) {
-    std::lock_guard<std::recursive_mutex> lock(mtx_);
-    if (net->dead) return;
-    net->dead = true;
-    dead_.push_back(net);
-}
+    if (net->dead.exchange(true)) return;
+    deadSize_++;
 
-void WorkingList::removeAllDead() {
-    std::lock_guard<std::recursive_mutex> lock(mtx_);
-    for (auto* net : dead_) {
-        array_[net->outSize]->remove(net);
+    RuntimeNetwork* unlinked = array_[net->outSize]->release(net->index);
+    if (unlinked != nullptr) {
+        epochs_.retire(unlinked);
     }
-    size_ -= static_cast<int>(dead_.size());
-    dead_.clear();
+}
 
-    while (first_ < static_cast<int>(array_.size()) && array_[first_]->size() == 0) {
-        first_++;
-    }
-    while (last_ >= 0 && array_[last_]->size() == 0) {
-        last_--;
-    }
+bool WorkingList::kill(RuntimeNetwork* killer, RuntimeNetwork* victim) {
+    std::lock_guard<std::mutex> lock(killMutex_);
+    if (killer->isDead()) return false;
+    addDead(victim);
+    return true;
 }
 
 void WorkingList::addNetwork(std::unique_ptr<RuntimeNetwork> net) {
-    std::lock_guard<std::recursive_mutex> lock(mtx_);
     net->createId();
     int outSize = net->outputSet()->size();
 
@@ -78,18 +106,17 @@ void WorkingList::addNetwork(std::unique_ptr<RuntimeNetwork> net) {
     }
 
     int id = net->getId();
+    net->outSize = outSize;
 
-    array_[outSize]->addNetwork(std::move(net));
-
-    if (maxId_ < id) {
-        maxId_ = id;
-    }
-    if (outSize < first_) {
-        first_ = outSize;
-    }
-    if (outSize > last_) {
-        last_ = outSize;
+    uint64_t certificate = net->certificate;
+    int index = array_[outSize]->addNetwork(std::move(net));
+    if (certificate != 0) {
+        certificates_.add(certificate, outSize, index);
     }
+
+    storeMax(maxId_, id);
+    storeMin(first_, outSize);
+    storeMax(last_, outSize);
     size_++;
 }
 
@@ -97,17 +124,15 @@ bool WorkingList::isFull() const {
     return aliveSize() >= NetworkGenerator::getWorkingListLimit();
 }
 
-std::vector<std::unique_ptr<RuntimeNetwork>>& WorkingList::networks(int outSize) {
-    return array_[outSize]->getNetworks();
-}
-
-std::vector<std::unique_ptr<RuntimeNetwork>> WorkingList::joinLists() const {
+std::vector<std::unique_ptr<RuntimeNetwork>> WorkingList::joinLists() {
     std::vector<std::unique_ptr<RuntimeNetwork>> all;
-    for (int i = first_; i <= last_; ++i) {
+    all.reserve(std::max(aliveSize(), 0));
+    for (int i = first(); i <= last(); ++i) {
         int n = array_[i]->size();
         for (int j = 0; j < n; ++j) {
             RuntimeNetwork* rawPtr = array_[i]->getNetwork(j);
-            all.emplace_back(std::make_unique<RuntimeNetwork>(*rawPtr));
+            if (rawPtr == nullptr || rawPtr->isDead()) continue;
+            all.emplace_back(array_[i]->release(j));
         }
     }
     return all;
@@ -115,7 +140,7 @@ std::vector<std::unique_ptr<RuntimeNetwork>> WorkingList::joinLists() const {
 
 std::string WorkingList::toString() const {
     std::ostringstream sb;
-    for (int i = first_; i <= last_; ++i) {
+    for (int i = first(); i <= last(); ++i) {
         auto& list = array_[i];
         sb << "\nsize " << i << "\t= " << list->size();
     }
@@ -2,48 +2,74 @@
 
 #include "NetworkList.h"
 #include "RuntimeNetwork.h"
+#include "EpochManager.h"
+#include "OutputHash.h"
+#include "OutputCertificate.h"
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <limits>
+#include <string>
 
+// Networks of the level being built, bucketed by output size.
+//
+// Appends and scans are lock-free: the buckets are append-only NetworkLists and
+// a network is removed by flagging it dead and unlinking it from its slot. The
+// unlinked network is retired to the epoch manager, so scans that may touch
+// networks of the list must hold an EpochManager::Guard on epochs().
 class WorkingList {
 private:
     std::vector<std::unique_ptr<NetworkList>> array_;
-    std::vector<RuntimeNetwork*> dead_;
-    mutable std::recursive_mutex mtx_;
+    EpochManager epochs_;
+    OutputHashSet outputs_;
+    CertificateIndex certificates_;
+    std::mutex killMutex_;
 
     int nbWires_;
-    int size_ = 0;
-    int maxId_ = -1;
-    int first_ = std::numeric_limits<int>::max();
-    int last_ = -1;
+    std::atomic<int> size_{ 0 };
+    std::atomic<int> deadSize_{ 0 };
+    std::atomic<int> maxId_{ -1 };
+    std::atomic<int> first_{ std::numeric_limits<int>::max() };
+    std::atomic<int> last_{ -1 };
 
 public:
     WorkingList(int nbWires, int maxOutSize);
 
     int size() const;
     int aliveSize() const;
+    // Deletes every network; no other thread may use the list meanwhile.
     void clear();
 
+    // nullptr for a slot being published or already removed.
     RuntimeNetwork* getNetwork(int outSize, int index) const;
     NetworkList* networkList(int outSize) const;
 
     void addDead(RuntimeNetwork* net);
-    void removeAllDead();
+    // Removes victim unless killer has been removed itself; serialized so that
+    // two networks subsuming each other cannot remove one another.
+    bool kill(RuntimeNetwork* killer, RuntimeNetwork* victim);
     void addNetwork(std::unique_ptr<RuntimeNetwork> net);
+    // Registers the output set of a network about to be added; false if a
+    // network with the same output set was already registered for this level.
+    bool claimOutput(const OutputHash& hash);
+    // The output sets registered so far, for a checkpoint.
+    std::vector<OutputHash> claimedOutputs() const;
+    // Whether a live network of the list has the certificate of net and an
+    // output set equal to that of net up to a permutation of the wires.
+    bool findEquivalent(RuntimeNetwork* net);
 
     bool isFull() const;
-    std::vector<std::unique_ptr<RuntimeNetwork>> joinLists() const;
+    // Moves the live networks out of the list, by output size; no other thread
+    // may use it meanwhile.
+    std::vector<std::unique_ptr<RuntimeNetwork>> joinLists();
 
-    int first() const { return first_; }
-    int last() const { return last_; }
-    int deadSize() const { return static_cast<int>(dead_.size()); }
-    int getMaxId() const { return maxId_; }
+    int first() const { return first_.load(); }
+    int last() const { return last_.load(); }
+    int deadSize() const { return deadSize_.load(); }
+    int getMaxId() const { return maxId_.load(); }
 
-    std::vector<std::unique_ptr<RuntimeNetwork>>& networks(int outSize);
+    EpochManager& epochs() { return epochs_; }
 
     std::string toString() const;
-
-    std::recursive_mutex& getMutex() { return mtx_; }
-    const std::recursive_mutex& getMutex() const { return mtx_; }
 };
@@ -3,14 +3,15 @@
 #include "FitnessBadPosCount.h"
 #include "Statistics.h"
 #include "Permutations.h"
-#include "Sequence.h"
+#include "Benchmarks.h"
+#include "Config.h"
 #include <iostream>
 #include <memory>
 #include <vector>
+#include <string>
 
 void generate(int nbWires, int fromSize, int toSize) {
     Permutations::get(0);
-    Sequence::getInstance(nbWires, 0);
 
     GreenFilter prefix(nbWires);
     NetworkGenerator generator(nbWires, fromSize, toSize, &prefix, nullptr);
@@ -22,7 +23,56 @@ void generate(int nbWires, int fromSize, int toSize) {
 }
 
 
-int main() {
+int main(int argc, char* argv[]) {
+    // "--seed <value>", "--export-text", "--checkpoint <dir>" and "--resume" may appear anywhere;
+    // the other arguments keep their positions
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            Config::set("seed", argv[++i]);
+        }
+        else if (arg == "--export-text") {
+            Config::set("textExport", "true");
+        }
+        else if (arg == "--checkpoint" && i + 1 < argc) {
+            Config::set("checkpointDir", argv[++i]);
+        }
+        else if (arg == "--resume") {
+            Config::set("resume", "true");
+        }
+        else {
+            args.push_back(arg);
+        }
+    }
+
+    std::string mode = args.size() > 0 ? args[0] : "";
+
+    if (mode == "--bench-bitset") {
+        Benchmarks::valuesBitSet("results", 7, 12);
+        return 0;
+    }
+
+    if (mode == "--bench-subsumption") {
+        Benchmarks::subsumption(args.size() > 1 ? args[1] : "results/subsumption_queries.txt");
+        return 0;
+    }
+
+    if (mode == "--bench-scheduler") {
+        Benchmarks::schedulers(args.size() > 1 ? args[1] : "bench",
+            args.size() > 2 ? std::stoi(args[2]) : 7, args.size() > 3 ? std::stoi(args[3]) : 8, 5);
+        return 0;
+    }
+
+    if (mode == "--bench-parser") {
+        Benchmarks::parser(args.size() > 1 ? args[1] : "bench",
+            args.size() > 2 ? std::stoi(args[2]) : 7, args.size() > 3 ? std::stoi(args[3]) : 8, 5);
+        return 0;
+    }
+
+    if (mode == "--record-subsumption") {
+        Config::set("subsumptionLog", args.size() > 1 ? args[1] : "results/subsumption_queries.txt");
+    }
 
     generate(7, 9, 16);
 